@@ -0,0 +1,137 @@
+#pragma once
+
+#include "combiners.h"
+#include "emission_waiters.h"
+#include "function_detail.h"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace is::signals::detail
+{
+
+/// Shared state of asynchronous emission, keeps copied arguments and slots until all slots called.
+/// Tasks store slot results into concurrent_combiner and count finished tasks with atomic counter,
+///  so calling slots takes no locks. The last finished task combines results, fulfills promise
+///  and wakes threads waiting for signal emission.
+template <class Combiner, class Result, class Signature, class... Args>
+class async_emission
+{
+public:
+	async_emission(std::vector<packed_function> slots, std::size_t taskCount, std::shared_ptr<const emission_waiters> waiters, Args... args)
+		: m_slots(std::move(slots))
+		, m_arguments(args...)
+		, m_results(m_slots.size())
+		, m_remainingTasks(taskCount)
+		, m_waiters(std::move(waiters))
+	{
+	}
+
+	async_emission(const async_emission&) = delete;
+	async_emission& operator=(const async_emission&) = delete;
+
+	std::size_t slot_count() const noexcept
+	{
+		return m_slots.size();
+	}
+
+	std::future<Result> get_future()
+	{
+		return m_promise.get_future();
+	}
+
+	// Calls slots in range [begin, end), each slot should be called by exactly one task.
+	void run(std::size_t begin, std::size_t end) noexcept
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			try
+			{
+				call_slot(i);
+			}
+			catch (...)
+			{
+				if (!m_failed.exchange(true, std::memory_order_relaxed))
+				{
+					m_exception = std::current_exception();
+				}
+			}
+		}
+		if (m_remainingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			complete();
+			m_waiters->notify();
+		}
+	}
+
+private:
+	using slot_result = std::invoke_result_t<function_proxy<Signature>&, Args...>;
+
+	struct no_results
+	{
+		explicit no_results(std::size_t /*slotCount*/) noexcept
+		{
+		}
+	};
+
+	using results_type = std::conditional_t<std::is_void_v<slot_result>, no_results, concurrent_combiner<Combiner, slot_result>>;
+
+	void call_slot(std::size_t index)
+	{
+		const auto& slot = m_slots[index];
+		if constexpr (std::is_void_v<slot_result>)
+		{
+			std::apply([&slot](auto&... args) {
+				slot.template call<Signature>(args...);
+			}, m_arguments);
+		}
+		else
+		{
+			m_results.set(index, std::apply([&slot](auto&... args) {
+				return slot.template call<Signature>(args...);
+			}, m_arguments));
+		}
+	}
+
+	// Counter decrement synchronizes all tasks with the last one, so results and exception are visible here.
+	void complete() noexcept
+	{
+		try
+		{
+			if (m_failed.load(std::memory_order_relaxed))
+			{
+				m_promise.set_exception(m_exception);
+			}
+			else if constexpr (std::is_void_v<Result>)
+			{
+				m_promise.set_value();
+			}
+			else
+			{
+				m_promise.set_value(m_results.get_value());
+			}
+		}
+		catch (...)
+		{
+			// Combiner failed, promise is not satisfied yet.
+			m_promise.set_exception(std::current_exception());
+		}
+	}
+
+	const std::vector<packed_function> m_slots;
+	const std::tuple<std::decay_t<Args>...> m_arguments;
+	results_type m_results;
+	std::atomic<std::size_t> m_remainingTasks;
+	const std::shared_ptr<const emission_waiters> m_waiters;
+	std::atomic<bool> m_failed = false;
+	std::exception_ptr m_exception;
+	std::promise<Result> m_promise;
+};
+
+} // namespace is::signals::detail
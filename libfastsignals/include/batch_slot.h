@@ -0,0 +1,41 @@
+#pragma once
+
+#include "function.h"
+#include "span.h"
+#include <tuple>
+#include <type_traits>
+
+namespace is::signals::detail
+{
+
+/// Wraps slot which receives the whole batch of emissions, see signal::connect_batch().
+/// Regular emission passes batch with one item, signal::emit_batch() passes all items with single call.
+template <class... Arguments>
+class batch_slot
+{
+public:
+	using item_type = std::tuple<std::decay_t<Arguments>...>;
+	using batch_type = span<const item_type>;
+	using slot_type = function<void(batch_type)>;
+
+	explicit batch_slot(slot_type slot)
+		: m_slot(std::move(slot))
+	{
+	}
+
+	void operator()(Arguments... args) const
+	{
+		const item_type item(args...);
+		m_slot(batch_type(&item, 1));
+	}
+
+	void call_batch(const batch_type& items) const
+	{
+		m_slot(batch_type(items));
+	}
+
+private:
+	slot_type m_slot;
+};
+
+} // namespace is::signals::detail
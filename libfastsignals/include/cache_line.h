@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+
+namespace is::signals::detail
+{
+
+/// Cache line size used to keep independently modified data on different cache lines.
+inline constexpr std::size_t cache_line_size = 64;
+
+} // namespace is::signals::detail
+
+// Define LIBFASTSIGNALS_CACHE_LINE_LAYOUT for library and all its users to place lock, slots and counters
+//  of each signal on separate cache lines, also separating them from shared_ptr reference counters.
+// It avoids false sharing between emitting threads and threads which connect, disconnect
+//  or otherwise change signal under its lock, but makes each signal a few times larger.
+#if defined(LIBFASTSIGNALS_CACHE_LINE_LAYOUT)
+#	define LIBFASTSIGNALS_CACHE_LINE_ALIGN alignas(::is::signals::detail::cache_line_size)
+#else
+#	define LIBFASTSIGNALS_CACHE_LINE_ALIGN
+#endif
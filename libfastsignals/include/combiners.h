@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace is::signals
 {
@@ -37,4 +40,50 @@ public:
 	using result_type = void;
 };
 
+/**
+ * This adaptor collects results of slots which are called on different threads and passes them
+ *  to Combiner in connection order. Each slot result has its own preallocated cell,
+ *  so slots finishing concurrently store results without locks.
+ * Caller should synchronize all set() calls with get_value(), for example, by counting finished slots.
+ */
+template <class Combiner, class T>
+class concurrent_combiner
+{
+public:
+	using result_type = typename Combiner::result_type;
+
+	explicit concurrent_combiner(std::size_t slotCount)
+		: m_results(slotCount)
+	{
+	}
+
+	/**
+	 * set(index, value) method stores result of slot with given index, can be called concurrently for different slots.
+	 */
+	template <class TRef>
+	void set(std::size_t index, TRef&& value)
+	{
+		m_results[index].emplace(std::forward<TRef>(value));
+	}
+
+	/**
+	 * get_value() method passes stored results to Combiner in slot index order, skipping slots without result.
+	 */
+	result_type get_value()
+	{
+		Combiner combiner;
+		for (auto& result : m_results)
+		{
+			if (result)
+			{
+				combiner(std::move(*result));
+			}
+		}
+		return combiner.get_value();
+	}
+
+private:
+	std::vector<std::optional<T>> m_results;
+};
+
 } // namespace is::signals
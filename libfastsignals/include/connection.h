@@ -14,18 +14,23 @@ class connection
 {
 public:
 	connection() noexcept;
-	explicit connection(detail::signal_impl_weak_ptr storage, uint64_t id) noexcept;
+	explicit connection(detail::slot_states_ptr states, detail::slot_key key) noexcept;
 	connection(const connection& other) noexcept;
 	connection& operator=(const connection& other) noexcept;
 	connection(connection&& other) noexcept;
 	connection& operator=(connection&& other) noexcept;
 
+	// Returns false after slot disconnected by any copy of connection, or after signal destroyed or cleared.
+	// Lock-free: reads slot state with one atomic load.
 	bool connected() const noexcept;
 	void disconnect() noexcept;
 
 protected:
-	detail::signal_impl_weak_ptr m_storage;
-	uint64_t m_id = 0;
+	friend class connection_group;
+
+	// States are shared with signal and outlive it.
+	detail::slot_states_ptr m_states;
+	detail::slot_key m_key;
 };
 
 // Connection class that supports blocking callback execution
@@ -54,6 +59,34 @@ protected:
 	impl_ptr m_impl;
 };
 
+// Connection of slot called via executor with limited queue, see overflow_policy.
+// Counts emissions which were never delivered to slot.
+class queued_connection : public connection
+{
+public:
+	struct queued_connection_impl
+	{
+		std::atomic<uint64_t> droppedCount = ATOMIC_VAR_INIT(0);
+		std::atomic<uint64_t> coalescedCount = ATOMIC_VAR_INIT(0);
+	};
+	using impl_ptr = std::shared_ptr<queued_connection_impl>;
+
+	queued_connection() noexcept;
+	explicit queued_connection(connection&& conn, impl_ptr&& impl) noexcept;
+	queued_connection(const queued_connection&) noexcept;
+	queued_connection& operator=(const queued_connection&) noexcept;
+	queued_connection(queued_connection&& other) noexcept;
+	queued_connection& operator=(queued_connection&& other) noexcept;
+
+	// Number of emissions dropped by drop_newest and drop_oldest policies.
+	uint64_t dropped_count() const noexcept;
+	// Number of emissions replaced by later emission with coalesce policy.
+	uint64_t coalesced_count() const noexcept;
+
+protected:
+	impl_ptr m_impl;
+};
+
 // Blocks advanced connection, so its callback will not be executed
 class shared_connection_block
 {
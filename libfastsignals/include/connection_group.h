@@ -0,0 +1,43 @@
+#pragma once
+
+#include "connection.h"
+#include <cstddef>
+#include <vector>
+
+namespace is::signals
+{
+
+// Connection group keeps connections of one object and disconnects them all in destructor.
+// Group sorts connections by signal on disconnect, so it locks each signal once
+//  and removes all slots of this group from signal with one compaction pass.
+// Group is movable, but not copyable. This class itself is not thread-safe.
+class connection_group
+{
+public:
+	connection_group() noexcept;
+	connection_group(const connection_group&) = delete;
+	connection_group& operator=(const connection_group&) = delete;
+	connection_group(connection_group&& other) noexcept;
+	connection_group& operator=(connection_group&& other) noexcept;
+	~connection_group();
+
+	// Adds connection to group, use scoped_connection::release() to add scoped connection.
+	void add(connection conn);
+
+	// Disconnects all connections of group and clears it.
+	void disconnect() noexcept;
+
+	size_t size() const noexcept;
+	bool empty() const noexcept;
+
+private:
+	struct entry
+	{
+		detail::slot_states_ptr states;
+		detail::slot_key key;
+	};
+
+	std::vector<entry> m_entries;
+};
+
+} // namespace is::signals
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "connection_table.h"
+#include <type_traits>
+
+namespace is::signals
+{
+
+// Compact connection handle: 8 bytes, trivially copyable and doesn't touch shared_ptr counters on copy.
+// Handle refers to entry of global connection table which is invalidated when slot is disconnected
+//  or signal is destroyed, so handle can be safely disconnected at any time.
+// Handle doesn't disconnect slot in destructor, and copies of handle refer to the same connection.
+// Connect slot with signal::connect(slot, handle_tag) to get handle.
+class connection_handle
+{
+public:
+	connection_handle() noexcept = default;
+	explicit connection_handle(detail::connection_handle_data data) noexcept;
+
+	// Returns true until slot is disconnected by any copy of handle, or until signal destroyed or cleared.
+	bool connected() const noexcept;
+
+	// Disconnects slot and resets this handle. Thread-safe: takes lock of connection table shard which keeps handle.
+	void disconnect() noexcept;
+
+	friend bool operator==(connection_handle lhs, connection_handle rhs) noexcept
+	{
+		return lhs.m_data.index == rhs.m_data.index && lhs.m_data.generation == rhs.m_data.generation;
+	}
+
+	friend bool operator!=(connection_handle lhs, connection_handle rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+private:
+	detail::connection_handle_data m_data;
+};
+
+static_assert(sizeof(connection_handle) == 8 && std::is_trivially_copyable_v<connection_handle>,
+	"connection_handle should be compact and trivially copyable");
+
+} // namespace is::signals
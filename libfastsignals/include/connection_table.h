@@ -0,0 +1,103 @@
+#pragma once
+
+#include "cache_line.h"
+#include "span.h"
+#include "spin_mutex.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace is::signals::detail
+{
+
+class signal_impl;
+
+/// Position of connection in global connection table, zero index means no connection.
+struct connection_handle_data
+{
+	std::uint32_t index = 0;
+	std::uint32_t generation = 0;
+};
+
+/// Connection table entry remembered by signal, so signal can invalidate it on destruction.
+struct connection_table_ref
+{
+	std::uint64_t slotId = 0;
+	connection_handle_data handle;
+};
+
+/// Global table which maps compact connection handles to signal and slot id.
+/// Entry is reused after disconnect with incremented generation, so stale handles never match it.
+/// Table is split into shards with separate locks, all entries of one signal are kept in one shard.
+/// Disconnect calls signal after shard unlocked, and signal waits for such calls on destruction,
+///  so handle can be used after signal destroyed without keeping weak_ptr.
+class connection_table
+{
+public:
+	static connection_table& instance() noexcept;
+
+	// Takes free entry for slot which is being connected to signal.
+	connection_handle_data acquire(signal_impl* signal);
+
+	// Takes entries for a few slots with one lock and appends them to handles.
+	void acquire(signal_impl* signal, std::size_t count, std::vector<connection_handle_data>& handles);
+
+	// Sets id of connected slot, does nothing if entry was released meanwhile.
+	void set_slot_id(connection_handle_data handle, std::uint64_t slotId) noexcept;
+
+	// Sets ids of slots connected with one lock, slot ids are sequential starting from firstSlotId.
+	void set_slot_ids(span<const connection_handle_data> handles, std::uint64_t firstSlotId) noexcept;
+
+	// Releases entry without disconnecting slot, used if connect failed.
+	void release(connection_handle_data handle) noexcept;
+	void release(span<const connection_handle_data> handles) noexcept;
+
+	// Releases entries of signal which is destroyed or which removed all its slots.
+	void release(const std::vector<connection_table_ref>& refs) noexcept;
+
+	bool connected(connection_handle_data handle) const noexcept;
+
+	void disconnect(connection_handle_data handle) noexcept;
+
+private:
+	// Handle index keeps shard in low bits, so number of shards is a power of two.
+	static constexpr std::uint32_t shard_bits = 4;
+	static constexpr std::uint32_t shard_count = 1u << shard_bits;
+	// Shard keeps this many entries when all of them are free, so connect and disconnect don't allocate each time.
+	static constexpr std::size_t retained_entries = 256;
+
+	struct entry
+	{
+		signal_impl* signal = nullptr;
+		std::uint64_t slotId = 0;
+		std::uint32_t generation = 1;
+		// Local index of the next free entry plus one, zero for the last one.
+		std::uint32_t nextFree = 0;
+	};
+
+	// Each shard has its own cache line, since threads spin on its lock.
+	struct alignas(cache_line_size) shard
+	{
+		mutable spin_mutex mutex;
+		// Deque never moves its items, so entries can be accessed by index.
+		std::deque<entry> entries;
+		std::uint32_t freeHead = 0;
+		std::uint32_t usedCount = 0;
+		// Generation of entries added after shard was cleared, so stale handles don't match them.
+		std::uint32_t firstGeneration = 1;
+	};
+
+	connection_table() = default;
+
+	static std::uint32_t shard_index(const signal_impl* signal) noexcept;
+	static std::uint32_t shard_index(connection_handle_data handle) noexcept;
+
+	static connection_handle_data acquire_locked(shard& owner, std::uint32_t shardIndex, signal_impl* signal);
+	static bool is_valid_locked(const shard& owner, connection_handle_data handle) noexcept;
+	static void release_locked(shard& owner, connection_handle_data handle) noexcept;
+
+	shard m_shards[shard_count];
+};
+
+} // namespace is::signals::detail
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "function.h"
+#include "signal_impl.h"
+#include "signal_policies.h"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace is::signals
+{
+namespace detail
+{
+
+class deferred_signal_base
+{
+public:
+	explicit deferred_signal_base(signal_impl_weak_ptr signal) noexcept
+		: m_signal(std::move(signal))
+	{
+	}
+
+	virtual ~deferred_signal_base() = default;
+
+	// Emits recorded emissions and forgets them.
+	virtual void deliver() = 0;
+
+	// Returns true if signal was destroyed, then other signal may have the same address.
+	bool expired() const noexcept
+	{
+		return m_signal.expired();
+	}
+
+	// Called on scope exit when signal no longer records emissions.
+	void release() noexcept
+	{
+		if (auto signal = m_signal.lock())
+		{
+			signal->remove_deferral();
+		}
+	}
+
+private:
+	const signal_impl_weak_ptr m_signal;
+};
+
+/// Emissions of one signal recorded by deferred_emission_scope.
+template <class... Arguments>
+class deferred_signal final : public deferred_signal_base
+{
+public:
+	using item_type = std::tuple<std::decay_t<Arguments>...>;
+	using reducer_type = function<void(item_type&, Arguments...)>;
+	using emit_type = function<void(Arguments...)>;
+
+	deferred_signal(signal_impl_weak_ptr signal, emit_type emit, deferral_policy policy, std::optional<reducer_type> reducer)
+		: deferred_signal_base(std::move(signal))
+		, m_emit(std::move(emit))
+		, m_policy(policy)
+		, m_reducer(std::move(reducer))
+	{
+	}
+
+	void record(Arguments... args)
+	{
+		if (m_items.empty() || m_policy == deferral_policy::all)
+		{
+			m_items.emplace_back(args...);
+		}
+		else if (m_reducer)
+		{
+			(*m_reducer)(m_items.front(), args...);
+		}
+		else
+		{
+			m_items.front() = item_type(args...);
+		}
+	}
+
+	void deliver() final
+	{
+		auto items = std::move(m_items);
+		m_items.clear();
+		for (const auto& item : items)
+		{
+			std::apply([this](const auto&... args) {
+				m_emit(args...);
+			}, item);
+		}
+	}
+
+private:
+	const emit_type m_emit;
+	const deferral_policy m_policy;
+	const std::optional<reducer_type> m_reducer;
+	std::vector<item_type> m_items;
+};
+
+// Returns recorded emissions of signal in the innermost scope of current thread which defers it, or nullptr.
+deferred_signal_base* find_deferred_signal(const signal_impl* signal) noexcept;
+
+} // namespace detail
+
+/// RAII scope which defers emissions of chosen signals until scope exit, like transaction for change notifications.
+/// While scope is active, emissions of deferred signals on the same thread are recorded instead of delivered.
+/// On scope exit each signal is emitted with the last recorded arguments, with all of them,
+///  or with arguments merged by reducer, see defer() methods. Signals are delivered in order of defer() calls.
+/// Scopes are thread-local: emissions on other threads are delivered immediately. Nested scope delivers
+///  its emissions on exit, and outer scope records them again if it defers the same signal.
+/// If scope exits because of exception, recorded emissions are discarded.
+class deferred_emission_scope
+{
+public:
+	deferred_emission_scope() noexcept;
+
+	/// Delivers recorded emissions, exception thrown by slot discards the rest of emissions.
+	~deferred_emission_scope() noexcept(false);
+
+	deferred_emission_scope(const deferred_emission_scope&) = delete;
+	deferred_emission_scope& operator=(const deferred_emission_scope&) = delete;
+
+	/**
+	 * defer(signal, policy) method makes scope record emissions of signal, see deferral_policy.
+	 * Deferring the same signal again has no effect. Signal should return void.
+	 */
+	template <class Signal>
+	void defer(Signal& signal, deferral_policy policy = deferral_policy::last)
+	{
+		defer_impl(signal, policy, std::nullopt);
+	}
+
+	/**
+	 * defer(signal, reducer) method makes scope merge recorded emissions of signal with reducer,
+	 *  which is called as reducer(mergedArgumentsTuple, args...) for each emission except the first one.
+	 * On scope exit signal is emitted once with merged arguments.
+	 */
+	template <class Signal, class Reducer>
+	void defer(Signal& signal, Reducer&& reducer)
+	{
+		defer_impl(signal, deferral_policy::last, typename Signal::deferred_signal_type::reducer_type(std::forward<Reducer>(reducer)));
+	}
+
+private:
+	friend detail::deferred_signal_base* detail::find_deferred_signal(const detail::signal_impl* signal) noexcept;
+
+	template <class Signal>
+	void defer_impl(Signal& signal, deferral_policy policy, std::optional<typename Signal::deferred_signal_type::reducer_type> reducer)
+	{
+		static_assert(std::is_void_v<typename Signal::combiner_type::result_type>, "Only signals returning void can be deferred");
+
+		const detail::signal_impl_ptr& impl = signal.m_slots;
+		if (find_own(impl.get()))
+		{
+			return;
+		}
+		m_signals.reserve(m_signals.size() + 1);
+		auto deferred = std::make_unique<typename Signal::deferred_signal_type>(impl, signal, policy, std::move(reducer));
+		impl->add_deferral();
+		m_signals.emplace_back(impl.get(), std::move(deferred));
+	}
+
+	detail::deferred_signal_base* find_own(const detail::signal_impl* signal) const noexcept;
+
+	deferred_emission_scope* m_parent = nullptr;
+	int m_uncaughtExceptions = 0;
+	std::vector<std::pair<const detail::signal_impl*, std::unique_ptr<detail::deferred_signal_base>>> m_signals;
+};
+
+} // namespace is::signals
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace is::signals
+{
+namespace detail
+{
+
+/// Object pointer and call stub of delegate, packed_function keeps it in buffer without proxy object.
+struct delegate_data
+{
+	void* object = nullptr;
+	void (*stub)() = nullptr;
+};
+
+template <auto Method, class Class, class Return, class... Arguments>
+Return call_method(void* object, Arguments&&... args)
+{
+	if constexpr (std::is_void_v<Return>)
+	{
+		(static_cast<Class*>(object)->*Method)(std::forward<Arguments>(args)...);
+	}
+	else
+	{
+		return (static_cast<Class*>(object)->*Method)(std::forward<Arguments>(args)...);
+	}
+}
+
+template <class Class>
+void* to_object_pointer(Class* object) noexcept
+{
+	return const_cast<std::remove_cv_t<Class>*>(object);
+}
+
+} // namespace detail
+
+/// Slot which calls given method of object, create it with mem_fn_slot<&Class::method>(object).
+/// Signal keeps such slot as delegate: object pointer and call stub without proxy object and vtable.
+/// Slot doesn't own object, so disconnect slot before object is destroyed.
+template <auto Method, class Class>
+class method_slot
+{
+public:
+	static_assert(std::is_member_function_pointer_v<decltype(Method)>, "method_slot needs pointer to member function");
+
+	explicit method_slot(Class* object) noexcept
+		: m_object(object)
+	{
+	}
+
+	template <class... Arguments>
+	decltype(auto) operator()(Arguments&&... args) const
+	{
+		return (m_object->*Method)(std::forward<Arguments>(args)...);
+	}
+
+	[[nodiscard]] Class* object() const noexcept
+	{
+		return m_object;
+	}
+
+	// Returns stub which calls method with given signature.
+	template <class Return, class... Arguments>
+	static auto get_stub() noexcept
+	{
+		return &detail::call_method<Method, Class, Return, Arguments...>;
+	}
+
+	friend bool operator==(const method_slot& lhs, const method_slot& rhs) noexcept
+	{
+		return lhs.m_object == rhs.m_object;
+	}
+
+	friend bool operator!=(const method_slot& lhs, const method_slot& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+private:
+	Class* m_object = nullptr;
+};
+
+/**
+ * mem_fn_slot<&Class::method>(object) function creates slot which calls method of object:
+ * `valueChanged.connect(mem_fn_slot<&Widget::onValueChanged>(this));`
+ */
+template <auto Method, class Class>
+method_slot<Method, Class> mem_fn_slot(Class* object) noexcept
+{
+	return method_slot<Method, Class>(object);
+}
+
+template <class Signature>
+class delegate;
+
+/// Trivially copyable callable which keeps object pointer and call stub, so it takes two pointers
+///  and is called with one indirect call. Signal keeps delegate without proxy object and vtable.
+/// Delegate doesn't own object, so disconnect it before object is destroyed.
+/// Empty delegate or delegate of null object cannot be connected, debug build asserts on it.
+template <class Return, class... Arguments>
+class delegate<Return(Arguments...)>
+{
+public:
+	using stub_type = Return (*)(void*, Arguments&&...);
+
+	delegate() = default;
+
+	template <auto Method, class Class>
+	delegate(method_slot<Method, Class> slot) noexcept
+		: m_object(detail::to_object_pointer(slot.object()))
+		, m_stub(method_slot<Method, Class>::template get_stub<Return, Arguments...>())
+	{
+	}
+
+	Return operator()(Arguments... args) const
+	{
+		return m_stub(m_object, std::forward<Arguments>(args)...);
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return m_stub != nullptr;
+	}
+
+	[[nodiscard]] void* object() const noexcept
+	{
+		return m_object;
+	}
+
+	[[nodiscard]] stub_type stub() const noexcept
+	{
+		return m_stub;
+	}
+
+	friend bool operator==(const delegate& lhs, const delegate& rhs) noexcept
+	{
+		return lhs.m_object == rhs.m_object && lhs.m_stub == rhs.m_stub;
+	}
+
+	friend bool operator!=(const delegate& lhs, const delegate& rhs) noexcept
+	{
+		return !(lhs == rhs);
+	}
+
+private:
+	void* m_object = nullptr;
+	stub_type m_stub = nullptr;
+};
+
+namespace detail
+{
+
+/// Constantly is true if packed_function with given signature can keep callable as delegate.
+template <class Callable, class Return, class... Arguments>
+inline constexpr bool is_delegate_callable = false;
+
+template <auto Method, class Class, class Return, class... Arguments>
+inline constexpr bool is_delegate_callable<method_slot<Method, Class>, Return, Arguments...> = true;
+
+template <class Return, class... Arguments>
+inline constexpr bool is_delegate_callable<delegate<Return(Arguments...)>, Return, Arguments...> = true;
+
+// Stub is stored as generic function pointer and cast back to stub of the same signature before call.
+template <class Return, class... Arguments, class Callable>
+delegate_data get_delegate_data(const Callable& callable) noexcept
+{
+	if constexpr (std::is_same_v<Callable, delegate<Return(Arguments...)>>)
+	{
+		return { callable.object(), reinterpret_cast<void (*)()>(callable.stub()) };
+	}
+	else
+	{
+		return { to_object_pointer(callable.object()), reinterpret_cast<void (*)()>(Callable::template get_stub<Return, Arguments...>()) };
+	}
+}
+
+} // namespace detail
+} // namespace is::signals
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if !defined(__linux__)
+#	include <condition_variable>
+#	include <mutex>
+#endif
+
+namespace is::signals::detail
+{
+
+/// Parks threads which wait for signal emission.
+/// Emission checks only waiters counter, so it doesn't cost anything except one load when nobody waits.
+/// All waiters sleep on the same emission counter, so one emission wakes them all with single syscall.
+/// On Linux waiters sleep on futex, on other platforms on condition variable.
+class emission_waiters
+{
+public:
+	emission_waiters() = default;
+	emission_waiters(const emission_waiters&) = delete;
+	emission_waiters& operator=(const emission_waiters&) = delete;
+
+	inline void notify() const noexcept
+	{
+		// Sequentially consistent load pairs with counter increment in wait_until(),
+		//  so emission which starts after waiter registered always wakes it up.
+		if (m_waiterCount.load() != 0)
+		{
+			notify_slow();
+		}
+	}
+
+	// Returns false if deadline expired before emission.
+	bool wait_until(std::chrono::steady_clock::time_point deadline) const;
+
+	// Waits without timeout.
+	void wait() const;
+
+private:
+	void notify_slow() const noexcept;
+	bool wait_impl(const std::chrono::steady_clock::time_point* deadline) const;
+
+	mutable std::atomic<std::uint32_t> m_waiterCount = 0;
+	// Incremented by each emission which has waiters, waiters sleep until it changes.
+	mutable std::atomic<std::uint32_t> m_emissionCount = 0;
+#if !defined(__linux__)
+	mutable std::mutex m_mutex;
+	mutable std::condition_variable m_emitted;
+#endif
+};
+
+} // namespace is::signals::detail
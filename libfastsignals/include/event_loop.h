@@ -0,0 +1,91 @@
+#pragma once
+
+#include "executor.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+#if !defined(__linux__)
+#	include <condition_variable>
+#	include <mutex>
+#endif
+
+namespace is::signals
+{
+
+/// Event loop runs tasks and queued slots on thread which calls run() methods, such as UI or IO thread.
+/// Connect slot with signal::connect(slot, loop) to call it on event loop thread.
+/// On Linux event loop is woken up via eventfd, see fd() method to embed it into existing epoll loop.
+/// Only the first task posted after event loop woke up writes into eventfd,
+///  so N emissions before event loop wakes up cost one syscall.
+class event_loop final : public executor
+{
+public:
+	event_loop();
+	~event_loop() override;
+
+	/**
+	 * run() method runs tasks until stop() is called.
+	 */
+	void run();
+
+	/**
+	 * run_once() method waits for tasks and runs them, including tasks posted while running.
+	 * Returns without waiting if stop() was called.
+	 * @returns number of tasks which were run
+	 */
+	std::size_t run_once();
+
+	/**
+	 * run_for(timeout) method runs tasks until timeout expires or stop() is called.
+	 * @returns number of tasks which were run
+	 */
+	template <class Rep, class Period>
+	std::size_t run_for(const std::chrono::duration<Rep, Period>& timeout)
+	{
+		return run_until(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout));
+	}
+
+	/**
+	 * poll() method runs queued tasks without waiting.
+	 * Call it when fd() becomes readable if event loop is embedded into other loop.
+	 * @returns number of tasks which were run
+	 */
+	std::size_t poll();
+
+	/**
+	 * stop() method makes run() and run_for() return after current task. Can be called from any thread.
+	 */
+	void stop() noexcept;
+
+	/**
+	 * fd() method returns eventfd which becomes readable when event loop has tasks, or -1 on platforms without eventfd.
+	 */
+	[[nodiscard]] int fd() const noexcept;
+
+protected:
+	void wakeup() noexcept final;
+
+private:
+	using time_point = std::chrono::steady_clock::time_point;
+
+	std::size_t run_until(time_point deadline);
+
+	// Waits until event loop is woken up and resets wakeup, returns false on timeout.
+	bool wait(std::optional<time_point> deadline);
+	// Returns without waiting if tasks left by previous run are pending.
+	bool wait_for_tasks(std::optional<time_point> deadline);
+	void reset_wakeup() noexcept;
+
+	std::atomic<bool> m_stopped = false;
+#if defined(__linux__)
+	int m_fd = -1;
+#else
+	std::mutex m_mutex;
+	std::condition_variable m_wakeup;
+	bool m_woken = false;
+#endif
+};
+
+} // namespace is::signals
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "cache_line.h"
+#include "function_detail.h"
+#include "mpsc_queue.h"
+#include "spin_mutex.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace is::signals
+{
+namespace detail
+{
+
+struct event_node : mpsc_node
+{
+	packed_task task;
+	// Index of the next node in free list plus one, zero for the last node.
+	std::atomic<std::uint32_t> nextFree = 0;
+	std::uint32_t index = 0;
+};
+
+} // namespace detail
+
+/// Lock-free queue of type-erased calls with many producers and single consumer.
+/// Events are stored in pooled nodes: consumer returns node to free list after call,
+///  so producers reuse nodes and steady-state push never allocates memory.
+/// Calls which fit small inline buffer, such as lambda with a few captured arguments, are stored in node itself.
+/// Bounded queue preallocates all nodes and rejects events when all nodes are in use,
+///  unbounded queue allocates new nodes when free list is empty.
+class event_queue
+{
+public:
+	/// Creates unbounded queue.
+	event_queue();
+
+	/// Creates bounded queue which keeps up to capacity events, capacity should be greater than zero.
+	explicit event_queue(std::size_t capacity);
+
+	event_queue(const event_queue&) = delete;
+	event_queue& operator=(const event_queue&) = delete;
+
+	/// Destroys events which weren't called.
+	~event_queue();
+
+	/**
+	 * try_push(fn) method queues call of fn. Thread-safe, lock-free unless unbounded queue grows.
+	 * @returns false if bounded queue is full
+	 */
+	template <class Fn>
+	bool try_push(Fn&& fn)
+	{
+		detail::event_node* node = acquire_node();
+		if (node == nullptr)
+		{
+			return false;
+		}
+		try
+		{
+			node->task.init(std::forward<Fn>(fn));
+		}
+		catch (...)
+		{
+			release_node(node);
+			throw;
+		}
+		m_events.push(node);
+		return true;
+	}
+
+	/**
+	 * try_call_one() method pops the oldest event and calls it. Can be called only by one thread at a time.
+	 * Event is destroyed even if call throws.
+	 * @returns false if queue is empty or if the oldest event isn't pushed completely yet
+	 */
+	bool try_call_one();
+
+	/**
+	 * is_bounded() method returns true if queue has fixed capacity
+	 */
+	[[nodiscard]] bool is_bounded() const noexcept;
+
+private:
+	event_queue(std::size_t firstChunkSize, bool bounded);
+
+	detail::event_node* acquire_node();
+	// Returns nullptr if free list isn't empty anymore.
+	detail::event_node* grow();
+	void release_node(detail::event_node* node) noexcept;
+	void push_free_nodes(detail::event_node* first, detail::event_node* last) noexcept;
+	detail::event_node* get_node(std::uint32_t index) const noexcept;
+
+	// Chunk k keeps (firstChunkSize << k) nodes, so index of node fits 32 bits.
+	static constexpr std::size_t max_chunk_count = 24;
+
+	detail::mpsc_queue m_events;
+
+	// Free list head keeps (index + 1) of the first free node in lower 32 bits and ABA tag in upper 32 bits.
+	alignas(detail::cache_line_size) std::atomic<std::uint64_t> m_freeHead = 0;
+
+	alignas(detail::cache_line_size) std::array<std::atomic<detail::event_node*>, max_chunk_count> m_chunks = {};
+	std::size_t m_firstChunkSize = 0;
+	std::size_t m_chunkCount = 0;
+	bool m_bounded = false;
+	detail::spin_mutex m_growMutex;
+};
+
+} // namespace is::signals
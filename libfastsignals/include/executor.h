@@ -0,0 +1,103 @@
+#pragma once
+
+#include "cache_line.h"
+#include "event_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace is::signals
+{
+
+/// Executor runs tasks on its own thread, it is used by queued connections, see signal::connect(slot, executor).
+/// Tasks are kept in lock-free event_queue owned by executor: any thread can post task without locks,
+///  and executor thread drains queue.
+/// Derived class implements wakeup() and calls run_queued_tasks() on executor thread.
+class executor
+{
+public:
+	executor() = default;
+
+	/// Creates executor with bounded task queue, so post() throws when queue keeps queueCapacity tasks.
+	explicit executor(std::size_t queueCapacity)
+		: m_queue(queueCapacity)
+	{
+	}
+
+	executor(const executor&) = delete;
+	executor& operator=(const executor&) = delete;
+
+	/// Destroys tasks which weren't run.
+	virtual ~executor() = default;
+
+	/**
+	 * post(task) method queues task for executor thread. Thread-safe, never blocks.
+	 * Tasks posted by one thread run in posting order.
+	 * Throws std::length_error if task queue rejects task, so task is never dropped silently.
+	 */
+	template <class Fn>
+	void post(Fn&& task)
+	{
+		if (!m_queue.try_push(std::forward<Fn>(task)))
+		{
+			throw std::length_error("executor task queue is full");
+		}
+		if (m_pendingCount.fetch_add(1, std::memory_order_release) == 0)
+		{
+			wakeup();
+		}
+	}
+
+protected:
+	/**
+	 * run_queued_tasks() method runs queued tasks until queue becomes empty, including tasks posted while running.
+	 * Should be called only from executor thread. Exception thrown by task leaves other tasks in queue
+	 *  and wakes up executor again, so they are run by the next call.
+	 * @returns number of tasks which were run
+	 */
+	std::size_t run_queued_tasks();
+
+	/// Returns true if posted tasks weren't run yet, for example because previous task threw exception.
+	bool has_pending_tasks() const noexcept
+	{
+		return m_pendingCount.load(std::memory_order_acquire) != 0;
+	}
+
+	/// Called when task is posted into empty queue, so executor thread should wake up and run queued tasks.
+	/// Since only the first task wakes up executor, tasks posted before executor thread woke up cost no extra wakeups.
+	virtual void wakeup() noexcept = 0;
+
+private:
+	event_queue m_queue;
+	// Number of posted tasks which weren't run yet.
+	alignas(detail::cache_line_size) std::atomic<std::size_t> m_pendingCount = 0;
+};
+
+/// Executor which runs tasks on its own worker thread.
+/// Tasks should not throw exceptions.
+class thread_executor final : public executor
+{
+public:
+	thread_executor();
+
+	/// Runs all queued tasks and stops worker thread.
+	~thread_executor() override;
+
+protected:
+	void wakeup() noexcept final;
+
+private:
+	void run();
+
+	std::mutex m_mutex;
+	std::condition_variable m_wakeup;
+	bool m_woken = false;
+	bool m_stopped = false;
+	std::thread m_thread;
+};
+
+} // namespace is::signals
@@ -38,8 +38,7 @@ public:
 
 	Return operator()(Arguments&&... args) const
 	{
-		auto& proxy = m_packed.get<Return(Arguments...)>();
-		return proxy(std::forward<Arguments>(args)...);
+		return m_packed.call<Return(Arguments...)>(std::forward<Arguments>(args)...);
 	}
 
 	detail::packed_function release() noexcept
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "delegate.h"
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -41,12 +46,83 @@ using callable_copy_t = std::conditional_t<std::is_function_v<std::remove_refere
 	Callable,
 	std::remove_cv_t<std::remove_reference_t<Callable>>>;
 
+/// Constantly is true if callable can receive batch of calls at once, see batch_slot.h.
+/// Such callable declares batch_type and call_batch(const batch_type&) method.
+template <class T, class = void>
+inline constexpr bool is_batch_callable = false;
+
+template <class T>
+inline constexpr bool is_batch_callable<T, std::void_t<typename T::batch_type>> = true;
+
+/// Has unique address for each type, so it identifies type without RTTI.
+template <class T>
+struct type_tag
+{
+	static constexpr char value = 0;
+};
+
+/// Type which identifies callable: function reference is compared as function pointer.
+template <class Callable>
+using callable_identity_t = std::decay_t<Callable>;
+
+/// Constantly is true if callable can be compared with callable of the same type, see signal::disconnect(slot).
+/// Function pointers, delegates and callables which declare operator== are comparable.
+template <class T, class = void>
+inline constexpr bool is_comparable_callable = false;
+
+template <class T>
+inline constexpr bool is_comparable_callable<T, std::void_t<decltype(bool(std::declval<const T&>() == std::declval<const T&>()))>> = true;
+
+inline size_t combine_hash(size_t seed, size_t value) noexcept
+{
+	return seed ^ (value + size_t(0x9e3779b9) + (seed << 6) + (seed >> 2));
+}
+
+template <class T>
+size_t get_pointer_hash(const T& pointer) noexcept
+{
+	// Function pointer cannot be converted to void*, so its bytes are hashed.
+	static_assert(sizeof(T) <= sizeof(uintptr_t[2]), "pointer is too large");
+	uintptr_t bytes[2] = {};
+	std::memcpy(bytes, &pointer, sizeof(T));
+	return combine_hash(std::hash<uintptr_t>()(bytes[0]), std::hash<uintptr_t>()(bytes[1]));
+}
+
+/// Hash of callable which is equal for equal callables. Hash never calls user code, so other comparable
+///  callables are hashed by type only and compared with operator== when signal looks for equal slot.
+template <class T>
+size_t get_identity_hash(const T& callable) noexcept
+{
+	const size_t typeHash = std::hash<const void*>()(&type_tag<T>::value);
+	if constexpr (std::is_pointer_v<T>)
+	{
+		return combine_hash(typeHash, get_pointer_hash(callable));
+	}
+	else
+	{
+		(void)callable;
+		return typeHash;
+	}
+}
+
+inline size_t get_identity_hash(const delegate_data& data) noexcept
+{
+	return combine_hash(std::hash<const void*>()(data.object), get_pointer_hash(data.stub));
+}
+
 class base_function_proxy
 {
 public:
 	virtual ~base_function_proxy() = default;
 	virtual base_function_proxy* clone(void* buffer) const = 0;
 	virtual base_function_proxy* move(void* buffer) noexcept = 0;
+	virtual const void* type_key() const noexcept = 0;
+
+	// Returns false if callable isn't comparable.
+	virtual bool get_identity_hash(size_t& hash) const noexcept = 0;
+
+	// Compares callable with given callable which has the same type key.
+	virtual bool equals(const void* callable) const = 0;
 };
 
 template <class Signature>
@@ -56,7 +132,23 @@ template <class Return, class... Arguments>
 class function_proxy<Return(Arguments...)> : public base_function_proxy
 {
 public:
+	// Stub of delegate which packed_function keeps instead of proxy, see delegate.h.
+	using delegate_stub = Return (*)(void*, Arguments&&...);
+
+	// Constantly is true if packed_function with this signature keeps callable as delegate.
+	template <class Callable>
+	static constexpr bool keeps_delegate = is_delegate_callable<Callable, Return, Arguments...>;
+
+	template <class Callable>
+	static delegate_data make_delegate_data(const Callable& callable) noexcept
+	{
+		return get_delegate_data<Return, Arguments...>(callable);
+	}
+
 	virtual Return operator()(Arguments&&...) = 0;
+
+	// Returns false if callable cannot receive batch, then caller should call it for each batch item.
+	virtual bool call_batch(const void* batch) = 0;
 };
 
 template <class Callable, class Return, class... Arguments>
@@ -79,6 +171,21 @@ public:
 		return m_callable(std::forward<Arguments>(args)...);
 	}
 
+	bool call_batch(const void* batch) final
+	{
+		using callable_t = callable_copy_t<Callable>;
+		if constexpr (is_batch_callable<callable_t>)
+		{
+			m_callable.call_batch(*static_cast<const typename callable_t::batch_type*>(batch));
+			return true;
+		}
+		else
+		{
+			(void)batch;
+			return false;
+		}
+	}
+
 	base_function_proxy* clone(void* buffer) const final
 	{
 		if constexpr (can_use_inplace_buffer<function_proxy_impl>)
@@ -107,13 +214,81 @@ public:
 		}
 	}
 
+	const void* type_key() const noexcept final
+	{
+		return &type_tag<identity_t>::value;
+	}
+
+	bool get_identity_hash(size_t& hash) const noexcept final
+	{
+		if constexpr (is_comparable_callable<identity_t>)
+		{
+			hash = detail::get_identity_hash<identity_t>(m_callable);
+			return true;
+		}
+		else
+		{
+			(void)hash;
+			return false;
+		}
+	}
+
+	bool equals(const void* callable) const final
+	{
+		if constexpr (is_comparable_callable<identity_t>)
+		{
+			const identity_t& identity = m_callable;
+			return bool(identity == *static_cast<const identity_t*>(callable));
+		}
+		else
+		{
+			(void)callable;
+			return false;
+		}
+	}
+
 private:
+	using identity_t = callable_identity_t<Callable>;
+
 	callable_copy_t<Callable> m_callable;
 };
 
 template <class Fn, class Return, class... Arguments>
 inline constexpr bool is_noexcept_packed_function_init = can_use_inplace_buffer<function_proxy_impl<Fn, Return, Arguments...>>;
 
+/// Proxy pointer of packed_function which keeps delegate in its buffer.
+/// Marker is only compared by address, packed_function never calls its methods.
+class delegate_marker_proxy final : public base_function_proxy
+{
+public:
+	base_function_proxy* clone(void* /*buffer*/) const final
+	{
+		return nullptr;
+	}
+
+	base_function_proxy* move(void* /*buffer*/) noexcept final
+	{
+		return nullptr;
+	}
+
+	const void* type_key() const noexcept final
+	{
+		return nullptr;
+	}
+
+	bool get_identity_hash(size_t& /*hash*/) const noexcept final
+	{
+		return false;
+	}
+
+	bool equals(const void* /*callable*/) const final
+	{
+		return false;
+	}
+};
+
+inline delegate_marker_proxy delegate_marker;
+
 class packed_function final
 {
 public:
@@ -132,7 +307,23 @@ public:
 		using proxy_t = function_proxy_impl<Callable, Return, Arguments...>;
 
 		assert(m_proxy == nullptr);
-		if constexpr (can_use_inplace_buffer<proxy_t>)
+		if constexpr (is_delegate_callable<callable_copy_t<Callable>, Return, Arguments...>)
+		{
+			// Method stub converts result to Return, but delegate accepts the same methods as other callables.
+			static_assert(std::is_same_v<std::invoke_result_t<Callable, Arguments...>, Return>,
+				"cannot construct function<> class from callable object with different return type");
+
+			// Delegate is kept as object pointer and stub, so call needs neither proxy nor vtable.
+			// Null delegate would crash on the first emission, so it is rejected when slot is connected.
+			const delegate_data data = get_delegate_data<Return, Arguments...>(function);
+			assert(data.object != nullptr && data.stub != nullptr && "cannot connect null delegate");
+			if (data.stub != nullptr)
+			{
+				new (&m_buffer) delegate_data(data);
+				m_proxy = &delegate_marker;
+			}
+		}
+		else if constexpr (can_use_inplace_buffer<proxy_t>)
 		{
 			m_proxy = new (&m_buffer) proxy_t{ std::forward<Callable>(function) };
 		}
@@ -142,22 +333,198 @@ public:
 		}
 	}
 
+	// Returns proxy of callable, throws std::bad_function_call if function is empty or keeps delegate.
 	template <class Signature>
 	function_proxy<Signature>& get() const
 	{
 		return static_cast<function_proxy<Signature>&>(unwrap());
 	}
 
+	// Calls function with given signature, delegate is called via its stub without virtual call.
+	template <class Signature, class... Args>
+	decltype(auto) call(Args&&... args) const
+	{
+		if (is_delegate())
+		{
+			const auto stub = reinterpret_cast<typename function_proxy<Signature>::delegate_stub>(get_delegate().stub);
+			return stub(get_delegate().object, std::forward<Args>(args)...);
+		}
+		return get<Signature>()(std::forward<Args>(args)...);
+	}
+
+	// Returns false if function cannot receive batch, then caller should call it for each batch item.
+	template <class Signature>
+	bool call_batch(const void* batch) const
+	{
+		return !is_delegate() && get<Signature>().call_batch(batch);
+	}
+
+	// Returns false if function is empty or keeps callable which isn't comparable.
+	bool get_identity_hash(size_t& hash) const noexcept
+	{
+		if (is_delegate())
+		{
+			hash = detail::get_identity_hash(get_delegate());
+			return true;
+		}
+		return m_proxy != nullptr && m_proxy->get_identity_hash(hash);
+	}
+
+	// Returns hash which function initialized with given callable would return from get_identity_hash().
+	template <class Signature, class Callable>
+	static size_t get_identity_hash_of(const Callable& callable) noexcept
+	{
+		using identity_t = callable_identity_t<Callable>;
+		if constexpr (function_proxy<Signature>::template keeps_delegate<identity_t>)
+		{
+			return detail::get_identity_hash(function_proxy<Signature>::make_delegate_data(callable));
+		}
+		else
+		{
+			return detail::get_identity_hash<identity_t>(callable);
+		}
+	}
+
+	// Returns true if function keeps callable equal to given one.
+	template <class Signature, class Callable>
+	bool equals(const Callable& callable) const
+	{
+		using identity_t = callable_identity_t<Callable>;
+		if constexpr (function_proxy<Signature>::template keeps_delegate<identity_t>)
+		{
+			const delegate_data data = function_proxy<Signature>::make_delegate_data(callable);
+			return is_delegate() && get_delegate().object == data.object && get_delegate().stub == data.stub;
+		}
+		else
+		{
+			const identity_t& identity = callable;
+			return !is_delegate() && m_proxy != nullptr && m_proxy->type_key() == &type_tag<identity_t>::value
+				&& m_proxy->equals(&identity);
+		}
+	}
+
 	void reset() noexcept;
 
+	bool empty() const noexcept
+	{
+		return m_proxy == nullptr;
+	}
+
+	// Returns the same key for functions which keep callables of the same type, or nullptr for empty function.
+	const void* type_key() const noexcept
+	{
+		if (is_delegate())
+		{
+			// Delegates with the same stub call the same function.
+			return reinterpret_cast<const void*>(get_delegate().stub);
+		}
+		return m_proxy ? m_proxy->type_key() : nullptr;
+	}
+
 private:
+	bool is_delegate() const noexcept
+	{
+		return m_proxy == &delegate_marker;
+	}
+
+	const delegate_data& get_delegate() const noexcept
+	{
+		return *std::launder(reinterpret_cast<const delegate_data*>(&m_buffer));
+	}
+
 	base_function_proxy* move_proxy_from(packed_function&& other) noexcept;
 	base_function_proxy* clone_proxy_from(const packed_function &other);
 	base_function_proxy& unwrap() const;
 	bool is_buffer_allocated() const noexcept;
+	// Returns true if buffer keeps proxy object or delegate.
+	bool is_buffer_used() const noexcept;
 
 	function_buffer_t m_buffer[1] = {};
 	base_function_proxy* m_proxy = nullptr;
 };
 
+class base_task_proxy
+{
+public:
+	virtual ~base_task_proxy() = default;
+	virtual void operator()() = 0;
+	virtual base_task_proxy* move(void* buffer) noexcept = 0;
+};
+
+template <class Callable>
+class task_proxy_impl final : public base_task_proxy
+{
+public:
+	template <class FunctionObject>
+	explicit task_proxy_impl(FunctionObject&& function)
+		: m_callable(std::forward<FunctionObject>(function))
+	{
+	}
+
+	void operator()() final
+	{
+		m_callable();
+	}
+
+	base_task_proxy* move(void* buffer) noexcept final
+	{
+		if constexpr (can_use_inplace_buffer<task_proxy_impl>)
+		{
+			base_task_proxy* moved = new (buffer) task_proxy_impl(std::move(*this));
+			this->~task_proxy_impl();
+			return moved;
+		}
+		else
+		{
+			(void)buffer;
+			return this;
+		}
+	}
+
+private:
+	callable_copy_t<Callable> m_callable;
+};
+
+/// Move-only analog of packed_function for calls without arguments.
+/// Accepts move-only callables, such as lambda which captured event arguments by move.
+class packed_task final
+{
+public:
+	packed_task() = default;
+	packed_task(packed_task&& other) noexcept;
+	packed_task& operator=(packed_task&& other) noexcept;
+	packed_task(const packed_task& other) = delete;
+	packed_task& operator=(const packed_task& other) = delete;
+	~packed_task() noexcept;
+
+	// Initializes packed task.
+	// Cannot be called without reset().
+	template <class Callable>
+	void init(Callable&& function) noexcept(can_use_inplace_buffer<task_proxy_impl<Callable>>)
+	{
+		using proxy_t = task_proxy_impl<Callable>;
+
+		assert(m_proxy == nullptr);
+		if constexpr (can_use_inplace_buffer<proxy_t>)
+		{
+			m_proxy = new (&m_buffer) proxy_t{ std::forward<Callable>(function) };
+		}
+		else
+		{
+			m_proxy = new proxy_t{ std::forward<Callable>(function) };
+		}
+	}
+
+	void operator()() const;
+
+	void reset() noexcept;
+
+private:
+	base_task_proxy* move_proxy_from(packed_task&& other) noexcept;
+	bool is_buffer_allocated() const noexcept;
+
+	function_buffer_t m_buffer[1] = {};
+	base_task_proxy* m_proxy = nullptr;
+};
+
 } // namespace is::signals::detail
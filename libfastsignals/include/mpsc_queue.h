@@ -0,0 +1,76 @@
+#pragma once
+
+#include "cache_line.h"
+#include <atomic>
+
+namespace is::signals::detail
+{
+
+/// Node of intrusive queue, derive queued item from it.
+struct mpsc_node
+{
+	std::atomic<mpsc_node*> next = nullptr;
+};
+
+/// Lock-free intrusive queue with many producers and single consumer.
+/// Push never blocks and takes one atomic exchange, pop can be called only from one thread at a time.
+/// Queue doesn't own nodes, consumer should destroy nodes returned by pop().
+class mpsc_queue
+{
+public:
+	mpsc_queue() = default;
+	mpsc_queue(const mpsc_queue&) = delete;
+	mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+	void push(mpsc_node* node) noexcept
+	{
+		node->next.store(nullptr, std::memory_order_relaxed);
+		mpsc_node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+		// Until this store node isn't visible to consumer, and pop() returns nullptr.
+		prev->next.store(node, std::memory_order_release);
+	}
+
+	/// Returns nullptr if queue is empty or if producer didn't finish push yet.
+	mpsc_node* pop() noexcept
+	{
+		mpsc_node* tail = m_tail;
+		mpsc_node* next = tail->next.load(std::memory_order_acquire);
+		if (tail == &m_stub)
+		{
+			if (next == nullptr)
+			{
+				return nullptr;
+			}
+			m_tail = next;
+			tail = next;
+			next = next->next.load(std::memory_order_acquire);
+		}
+		if (next != nullptr)
+		{
+			m_tail = next;
+			return tail;
+		}
+
+		// Tail is the last node, it can be returned only after stub node pushed behind it.
+		if (tail != m_head.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		push(&m_stub);
+		next = tail->next.load(std::memory_order_acquire);
+		if (next != nullptr)
+		{
+			m_tail = next;
+			return tail;
+		}
+		return nullptr;
+	}
+
+private:
+	// Producers and consumer modify different cache lines.
+	alignas(cache_line_size) std::atomic<mpsc_node*> m_head = &m_stub;
+	alignas(cache_line_size) mpsc_node* m_tail = &m_stub;
+	mpsc_node m_stub;
+};
+
+} // namespace is::signals::detail
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "connection.h"
+#include "executor.h"
+#include "function.h"
+#include "signal_policies.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace is::signals::detail
+{
+
+/// Keeps emissions of queued connection with limited queue until executor delivers them to slot.
+/// Each stored emission has exactly one task in executor queue, so executor queue is limited too.
+template <class... Arguments>
+class queued_slot_mailbox : public std::enable_shared_from_this<queued_slot_mailbox<Arguments...>>
+{
+public:
+	using slot_type = function<void(Arguments...)>;
+
+	queued_slot_mailbox(slot_type slot, executor& executor, queue_limit limit, queued_connection::impl_ptr counters)
+		: m_slot(std::move(slot))
+		, m_executor(executor)
+		, m_policy(limit.policy)
+		, m_counters(std::move(counters))
+		, m_items(limit.policy == overflow_policy::coalesce ? 1 : std::max(limit.capacity, std::size_t(1)))
+	{
+	}
+
+	void push(Arguments... args)
+	{
+		std::unique_lock lock(m_mutex);
+		bool replaced = false;
+		if (m_count == m_items.size())
+		{
+			switch (m_policy)
+			{
+			case overflow_policy::block:
+				++m_waitingCount;
+				m_notFull.wait(lock, [this] {
+					return m_count < m_items.size();
+				});
+				--m_waitingCount;
+				break;
+			case overflow_policy::drop_newest:
+				m_counters->droppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			case overflow_policy::drop_oldest:
+			case overflow_policy::coalesce:
+			{
+				// Task of dropped emission will deliver the new one.
+				pop_front_locked();
+				auto& counter = (m_policy == overflow_policy::coalesce) ? m_counters->coalescedCount : m_counters->droppedCount;
+				counter.fetch_add(1, std::memory_order_relaxed);
+				replaced = true;
+				break;
+			}
+			}
+		}
+
+		auto& item = m_items[(m_first + m_count) % m_items.size()];
+		item.args.emplace(args...);
+		item.id = ++m_lastId;
+		const std::uint64_t id = item.id;
+		++m_count;
+		lock.unlock();
+
+		if (!replaced)
+		{
+			try
+			{
+				m_executor.post([weakSelf = this->weak_from_this()] {
+					// Slot is not called after disconnect.
+					if (auto self = weakSelf.lock())
+					{
+						self->deliver();
+					}
+				});
+			}
+			catch (...)
+			{
+				remove_unscheduled(id);
+				throw;
+			}
+		}
+	}
+
+private:
+	using arguments_type = std::tuple<std::decay_t<Arguments>...>;
+
+	struct stored_emission
+	{
+		std::optional<arguments_type> args;
+		// Identifies emission which task wasn't posted, see remove_unscheduled().
+		std::uint64_t id = 0;
+	};
+
+	void deliver()
+	{
+		std::unique_lock lock(m_mutex);
+		if (m_count == 0)
+		{
+			return;
+		}
+		arguments_type args = pop_front_locked();
+		if (m_waitingCount != 0)
+		{
+			m_notFull.notify_all();
+		}
+		lock.unlock();
+
+		std::apply(m_slot, args);
+	}
+
+	arguments_type pop_front_locked()
+	{
+		auto& item = m_items[m_first];
+		arguments_type args = std::move(*item.args);
+		item.args.reset();
+		m_first = (m_first + 1) % m_items.size();
+		--m_count;
+		return args;
+	}
+
+	// Called when executor rejected task of emission with given id: one stored emission is removed,
+	//  so each stored emission still has one task and the next emission posts its own task.
+	void remove_unscheduled(std::uint64_t id)
+	{
+		std::lock_guard lock(m_mutex);
+		if (m_count == 0)
+		{
+			return;
+		}
+		// Emission could be replaced by newer one on overflow, then newer emission relies on rejected task.
+		std::size_t position = m_count - 1;
+		for (std::size_t i = 0; i < m_count; ++i)
+		{
+			if (m_items[(m_first + i) % m_items.size()].id == id)
+			{
+				position = i;
+				break;
+			}
+		}
+		if (m_items[(m_first + position) % m_items.size()].id != id)
+		{
+			m_counters->droppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		for (std::size_t i = position; i + 1 < m_count; ++i)
+		{
+			m_items[(m_first + i) % m_items.size()] = std::move(m_items[(m_first + i + 1) % m_items.size()]);
+		}
+		m_items[(m_first + m_count - 1) % m_items.size()].args.reset();
+		--m_count;
+		if (m_waitingCount != 0)
+		{
+			m_notFull.notify_all();
+		}
+	}
+
+	slot_type m_slot;
+	executor& m_executor;
+	const overflow_policy m_policy;
+	const queued_connection::impl_ptr m_counters;
+
+	std::mutex m_mutex;
+	std::condition_variable m_notFull;
+	// Ring buffer of pending emissions, allocated once on connect.
+	std::vector<stored_emission> m_items;
+	std::size_t m_first = 0;
+	std::size_t m_count = 0;
+	std::size_t m_waitingCount = 0;
+	std::uint64_t m_lastId = 0;
+};
+
+} // namespace is::signals::detail
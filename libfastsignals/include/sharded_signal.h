@@ -0,0 +1,242 @@
+#pragma once
+
+#include "cache_line.h"
+#include "signal.h"
+#include <array>
+#include <functional>
+#include <thread>
+
+namespace is::signals
+{
+namespace detail
+{
+
+/// Keeps slots in a few signal_impl shards, each with its own lock.
+/// Slot ids are taken from one counter, so emission can merge shards in connection order.
+template <size_t ShardCount>
+class sharded_signal_impl
+{
+public:
+	static_assert(ShardCount > 0, "sharded signal needs at least one shard");
+
+	signal_impl& get_shard_for_this_thread() noexcept
+	{
+		// Threads usually connect and disconnect from the same shard, so they don't contend with other threads.
+		const size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % ShardCount;
+		return m_shards[index].impl;
+	}
+
+	slot_key add(signal_impl& shard, packed_function fn)
+	{
+		return shard.add(std::move(fn), m_nextId);
+	}
+
+	void remove_all() noexcept
+	{
+		for (auto& shard : m_shards)
+		{
+			shard.impl.remove_all();
+		}
+	}
+
+	size_t count() const noexcept
+	{
+		size_t result = 0;
+		for (const auto& shard : m_shards)
+		{
+			result += shard.impl.count();
+		}
+		return result;
+	}
+
+	template <class Combiner, class Result, class Signature, class... Args>
+	Result invoke(Args... args)
+	{
+		if constexpr (std::is_same_v<Result, void>)
+		{
+			invoke_in_order([&](const packed_function& slot) {
+				slot.call<Signature>(std::forward<Args>(args)...);
+			});
+		}
+		else
+		{
+			Combiner combiner;
+			invoke_in_order([&](const packed_function& slot) {
+				combiner(slot.call<Signature>(std::forward<Args>(args)...));
+			});
+			return combiner.get_value();
+		}
+	}
+
+private:
+	struct alignas(cache_line_size) shard
+	{
+		signal_impl impl;
+	};
+
+	struct shard_cursor
+	{
+		size_t index = 0;
+		uint64_t nextId = 1;
+		bool finished = false;
+	};
+
+	template <class Callback>
+	void invoke_in_order(Callback&& callback)
+	{
+		// Merges slots of all shards by id. Each cursor keeps id of the next slot in its shard,
+		//  and the shard gives its slot only if no other shard has slot with lesser id.
+		std::array<shard_cursor, ShardCount> cursors;
+		packed_function slot;
+		while (true)
+		{
+			size_t current = ShardCount;
+			uint64_t maxId = std::numeric_limits<uint64_t>::max();
+			for (size_t i = 0; i < ShardCount; ++i)
+			{
+				if (cursors[i].finished)
+				{
+					continue;
+				}
+				if (current == ShardCount || cursors[i].nextId < cursors[current].nextId)
+				{
+					if (current != ShardCount)
+					{
+						maxId = cursors[current].nextId;
+					}
+					current = i;
+				}
+				else
+				{
+					maxId = std::min(maxId, cursors[i].nextId);
+				}
+			}
+			if (current == ShardCount)
+			{
+				break;
+			}
+
+			auto& cursor = cursors[current];
+			const uint64_t nextId = cursor.nextId;
+			if (m_shards[current].impl.get_next_slot(slot, cursor.index, cursor.nextId, maxId))
+			{
+				callback(slot);
+			}
+			else if (cursor.nextId == nextId)
+			{
+				cursor.finished = true;
+			}
+		}
+	}
+
+	std::array<shard, ShardCount> m_shards;
+	alignas(cache_line_size) std::atomic<uint64_t> m_nextId = 1;
+};
+
+} // namespace detail
+
+template <class Signature, template <class T> class Combiner = optional_last_value, size_t ShardCount = 8>
+class sharded_signal;
+
+/// Sharded signal has the same API as signal, but splits slots across a few shards, each with its own lock.
+/// Threads which connect and disconnect slots mostly use different shards, so they don't block each other
+///  and don't block emission. Slots are still called in connection order.
+/// Use it for signals with many thousands of slots which are frequently connected and disconnected
+///  from different threads, ordinary signal is faster in other cases.
+template <class Return, class... Arguments, template <class T> class Combiner, size_t ShardCount>
+class sharded_signal<Return(Arguments...), Combiner, ShardCount> : private not_directly_callable
+{
+public:
+	using signature_type = Return(signal_arg_t<Arguments>...);
+	using slot_type = function<signature_type>;
+	using combiner_type = Combiner<Return>;
+	using result_type = typename combiner_type::result_type;
+
+	sharded_signal()
+		: m_impl(std::make_shared<impl_type>())
+	{
+	}
+
+	/// No copy construction
+	sharded_signal(const sharded_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	sharded_signal(sharded_signal&& other) = default;
+
+	/// No copy assignment
+	sharded_signal& operator=(const sharded_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	sharded_signal& operator=(sharded_signal&& other) = default;
+
+	/**
+	 * connect(slot) method subscribes slot to signal emission event.
+	 * Each time you call signal as functor, all slots are also called with given arguments.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(slot_type slot)
+	{
+		auto& shard = m_impl->get_shard_for_this_thread();
+		const auto key = m_impl->add(shard, slot.release());
+		return connection(shard.states(), key);
+	}
+
+	/**
+	 * disconnect_all_slots() method disconnects all slots from signal emission event.
+	 */
+	void disconnect_all_slots() noexcept
+	{
+		m_impl->remove_all();
+	}
+
+	/**
+	 * num_slots() method returns number of slots attached to this singal
+	 */
+	[[nodiscard]] std::size_t num_slots() const noexcept
+	{
+		return m_impl->count();
+	}
+
+	/**
+	 * empty() method returns true if signal has any slots attached
+	 */
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return m_impl->count() == 0;
+	}
+
+	/**
+	 * operator(args...) calls all slots connected to this signal.
+	 * Logically, it fires signal emission event.
+	 */
+	result_type operator()(signal_arg_t<Arguments>... args) const
+	{
+		return impl_ptr(m_impl)->template invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+	}
+
+	void swap(sharded_signal& other) noexcept
+	{
+		m_impl.swap(other.m_impl);
+	}
+
+	/**
+	 * Allows using signals as slots for another signal
+	 */
+	operator slot_type() const noexcept
+	{
+		return [weakImpl = std::weak_ptr<impl_type>(m_impl)](signal_arg_t<Arguments>... args) {
+			if (auto impl = weakImpl.lock())
+			{
+				return impl->template invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+			}
+		};
+	}
+
+private:
+	using impl_type = detail::sharded_signal_impl<ShardCount>;
+	using impl_ptr = std::shared_ptr<impl_type>;
+
+	impl_ptr m_impl;
+};
+
+} // namespace is::signals
@@ -1,11 +1,25 @@
 #pragma once
 
+#include "batch_slot.h"
 #include "combiners.h"
 #include "connection.h"
+#include "connection_group.h"
+#include "connection_handle.h"
+#include "deferred_emission.h"
+#include "executor.h"
 #include "function.h"
+#include "queued_slot.h"
+#include "signal_coroutines.h"
 #include "signal_impl.h"
+#include "span.h"
 #include "type_traits.h"
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #if defined(_MSC_VER)
 #	include "msvc_autolink.h"
@@ -20,6 +34,10 @@ struct advanced_tag
 {
 };
 
+struct handle_tag
+{
+};
+
 /// Signal allows to fire events to many subscribers (slots).
 /// In other words, it implements one-to-many relation between event and listeners.
 /// Signal implements observable object from Observable pattern.
@@ -31,6 +49,8 @@ public:
 	using slot_type = function<signature_type>;
 	using combiner_type = Combiner<Return>;
 	using result_type = typename combiner_type::result_type;
+	using batch_item_type = std::tuple<std::decay_t<Arguments>...>;
+	using batch_slot_type = function<void(span<const batch_item_type>)>;
 
 	signal()
 		: m_slots(std::make_shared<detail::signal_impl>())
@@ -56,8 +76,57 @@ public:
 	 */
 	connection connect(slot_type slot)
 	{
-		const uint64_t id = m_slots->add(slot.release());
-		return connection(m_slots, id);
+		const auto key = m_slots->add(slot.release());
+		return connection(m_slots->states(), key);
+	}
+
+	/**
+	 * connect(slot, position) method subscribes slot which is called before (at_front) or after (at_back) ungrouped slots.
+	 * Slot connected at front never moves other slots, so it costs as much as connect(slot).
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(slot_type slot, connect_position position)
+	{
+		const auto key = m_slots->add_ungrouped(slot.release(), position);
+		return connection(m_slots->states(), key);
+	}
+
+	/**
+	 * connect(group, slot, position) method subscribes slot to given group.
+	 * Groups are called in ascending order after ungrouped slots connected at front and before other ungrouped slots.
+	 * Within group slots connected at front are called first, then slots connected at back.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(int group, slot_type slot, connect_position position = connect_position::at_back)
+	{
+		const auto key = m_slots->add_to_group(slot.release(), group, position);
+		return connection(m_slots->states(), key);
+	}
+
+	/**
+	 * connect_once(slot) method subscribes slot which is disconnected after the first call.
+	 * Slot is retired under the same lock which emission takes to get it, so concurrent emissions call it only once.
+	 * Note that signal with such slots cannot be frozen.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect_once(slot_type slot)
+	{
+		return connect_n(std::move(slot), 1);
+	}
+
+	/**
+	 * connect_n(slot, count) method subscribes slot which is disconnected after given number of calls.
+	 * Each emission counts as one call, including emit_batch() which passes all items to slot.
+	 * @returns connection - object which manages signal-slot connection lifetime, or empty connection if count is zero
+	 */
+	connection connect_n(slot_type slot, std::size_t count)
+	{
+		if (count == 0)
+		{
+			return connection();
+		}
+		const auto key = m_slots->add_limited(slot.release(), count);
+		return connection(m_slots->states(), key);
 	}
 
 	/**
@@ -81,6 +150,110 @@ public:
 		return advanced_connection(std::move(conn), std::move(conn_impl));
 	}
 
+	/**
+	 * connect(slot, handle_tag) method subscribes slot to signal emission event and returns compact connection handle.
+	 * Handle is 8 bytes, trivially copyable and can be disconnected even after signal is destroyed.
+	 * Use it to keep many connections, for example, in vector.
+	 * @returns connection_handle - trivially copyable handle which can disconnect slot
+	 */
+	connection_handle connect(slot_type slot, handle_tag)
+	{
+		return connection_handle(m_slots->add_with_handle(slot.release()));
+	}
+
+	/**
+	 * connect_range(first, last) method subscribes all slots from range with one lock and one storage reallocation.
+	 * Use it to wire many slots at startup: it's faster than calling connect() for each slot.
+	 * Slots are called in range order. If any slot cannot be connected, none of them is connected.
+	 * @returns vector of compact connection handles in range order, see connect(slot, handle_tag)
+	 */
+	template <class InputIt>
+	std::vector<connection_handle> connect_range(InputIt first, InputIt last)
+	{
+		std::vector<detail::packed_function> functions;
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+		{
+			functions.reserve(static_cast<std::size_t>(std::distance(first, last)));
+		}
+		for (; first != last; ++first)
+		{
+			functions.push_back(slot_type(*first).release());
+		}
+
+		std::vector<detail::connection_handle_data> handles;
+		m_slots->add_with_handles(functions, handles);
+		return std::vector<connection_handle>(handles.begin(), handles.end());
+	}
+
+	/**
+	 * connect_batch(slot) method subscribes slot which receives all items of emit_batch() with single call.
+	 * Regular emission calls this slot with batch of one item.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect_batch(batch_slot_type slot)
+	{
+		static_assert_batch_emission();
+		return connect(detail::batch_slot<signal_arg_t<Arguments>...>(std::move(slot)));
+	}
+
+	/**
+	 * connect(slot, executor) method subscribes slot which is called on executor thread, like Qt queued connection.
+	 * Emission copies arguments into task and posts it to executor queue without waiting for slot call.
+	 * Slot is not called for emissions queued before disconnect, but not run yet.
+	 * Executor must outlive connection.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(slot_type slot, executor& executor)
+	{
+		static_assert_queued_connect();
+
+		// Queued tasks keep weak reference, so disconnected slot destroyed without waiting for executor.
+		auto sharedSlot = std::make_shared<slot_type>(std::move(slot));
+		return connect([&executor, sharedSlot](signal_arg_t<Arguments>... args) {
+			executor.post([weakSlot = std::weak_ptr<slot_type>(sharedSlot), args...] {
+				if (auto slot = weakSlot.lock())
+				{
+					(*slot)(args...);
+				}
+			});
+		});
+	}
+
+	/**
+	 * connect(slot, executor, limit) method subscribes slot which is called on executor thread,
+	 *  but limits number of emissions which wait for delivery to slot, see overflow_policy.
+	 * Note that overflow_policy::block deadlocks if signal is emitted on executor thread and queue is full.
+	 * If executor throws on post, emission is removed from queue and exception is passed to emitting thread.
+	 * Executor must outlive connection.
+	 * @returns queued_connection - object which manages signal-slot connection lifetime and counts dropped emissions
+	 */
+	queued_connection connect(slot_type slot, executor& executor, queue_limit limit)
+	{
+		static_assert_queued_connect();
+
+		auto counters = std::make_shared<queued_connection::queued_connection_impl>();
+		auto mailbox = std::make_shared<detail::queued_slot_mailbox<signal_arg_t<Arguments>...>>(std::move(slot), executor, limit, counters);
+		auto conn = connect([mailbox = std::move(mailbox)](signal_arg_t<Arguments>... args) {
+			mailbox->push(args...);
+		});
+		return queued_connection(std::move(conn), std::move(counters));
+	}
+
+	/**
+	 * disconnect(slot) method disconnects all slots equal to given one, as boost::signals2 does.
+	 * Slot should be comparable: function pointer, mem_fn_slot(), delegate or callable with operator==.
+	 * Slots are looked up by hash, so it doesn't iterate all slots. Equal slots are found by hash of
+	 *  function pointer or delegate target, other callables are hashed by type and compared with operator==.
+	 * Candidate slots are copied under signal lock and compared with operator== after unlocking it.
+	 */
+	template <class Slot>
+	void disconnect(const Slot& slot)
+	{
+		static_assert(detail::is_comparable_callable<detail::callable_identity_t<Slot>>,
+			"disconnect(slot) needs function pointer, delegate or callable with operator==");
+		m_slots->remove_equal<signature_type>(slot);
+	}
+
 	/**
 	 * disconnect_all_slots() method disconnects all slots from signal emission event.
 	 */
@@ -105,13 +278,254 @@ public:
 		return m_slots->count() == 0;
 	}
 
+	/**
+	 * reserve(capacity) method preallocates storage for given number of slots,
+	 *  so connecting up to this number of slots won't reallocate storage.
+	 */
+	void reserve(std::size_t capacity)
+	{
+		m_slots->reserve(capacity);
+	}
+
+	/**
+	 * shrink_to_fit() method releases storage reserved for disconnected slots.
+	 */
+	void shrink_to_fit() noexcept
+	{
+		m_slots->shrink_to_fit();
+	}
+
+	/**
+	 * set_shrink_policy(policy) method defines if storage automatically shrinks after slots disconnected.
+	 * Default policy is shrink_policy::automatic.
+	 */
+	void set_shrink_policy(shrink_policy policy) noexcept
+	{
+		m_slots->set_shrink_policy(policy);
+	}
+
+	/**
+	 * capacity() method returns number of slots which can be connected without storage reallocation
+	 */
+	[[nodiscard]] std::size_t capacity() const noexcept
+	{
+		return m_slots->capacity();
+	}
+
+	/**
+	 * freeze(policy) method makes snapshot of connected slots which is used by emission without any locks.
+	 * Use it for signals which are wired once at startup and never changed later.
+	 * Connect or disconnect on frozen signal either unfreezes it or throws, see freeze_policy.
+	 * Note that frozen slots called in-place without copying, so they should be safe to call concurrently
+	 *  if signal is emitted from a few threads.
+	 */
+	void freeze(freeze_policy policy = freeze_policy::unfreeze_on_change)
+	{
+		m_slots->freeze(policy);
+	}
+
+	/**
+	 * unfreeze() method returns signal into default mode where slots can be connected and disconnected.
+	 */
+	void unfreeze() noexcept
+	{
+		m_slots->unfreeze();
+	}
+
+	/**
+	 * is_frozen() method returns true if signal uses frozen slots snapshot for emission
+	 */
+	[[nodiscard]] bool is_frozen() const noexcept
+	{
+		return m_slots->is_frozen();
+	}
+
+	/**
+	 * set_parallel_emission(pool, slotsPerTask) method makes emission split slots into tasks
+	 *  with given number of slots and run these tasks on thread pool, see thread_pool.h.
+	 * Emission returns when all slots called, combiner receives slot results in connection order.
+	 * Slots are called concurrently, so they should be thread-safe.
+	 * Use it for signals with many independent CPU-heavy slots, pass nullptr to return to sequential emission.
+	 */
+	void set_parallel_emission(std::shared_ptr<thread_pool> pool, std::size_t slotsPerTask = 1) noexcept
+	{
+		m_slots->set_parallel_emission(std::move(pool), slotsPerTask);
+	}
+
+	/**
+	 * wait() method blocks calling thread until signal is emitted on other thread and all slots are called.
+	 * Waiting threads don't connect slots: emission wakes all of them at once and costs one atomic load if nobody waits.
+	 */
+	void wait() const
+	{
+		m_slots->wait();
+	}
+
+	/**
+	 * wait(timeout) method blocks calling thread until signal is emitted on other thread or timeout expires.
+	 * @returns true if signal was emitted, false on timeout
+	 */
+	template <class Rep, class Period>
+	bool wait(const std::chrono::duration<Rep, Period>& timeout) const
+	{
+		return m_slots->wait_until(std::chrono::steady_clock::now() + std::chrono::ceil<std::chrono::steady_clock::duration>(timeout));
+	}
+
+	/**
+	 * wait_until(deadline) method blocks calling thread until signal is emitted on other thread or deadline expires.
+	 * @returns true if signal was emitted, false on timeout
+	 */
+	template <class Clock, class Duration>
+	bool wait_until(const std::chrono::time_point<Clock, Duration>& deadline) const
+	{
+		using steady_duration = std::chrono::steady_clock::duration;
+		if constexpr (std::is_same_v<Clock, std::chrono::steady_clock>)
+		{
+			return m_slots->wait_until(std::chrono::ceil<steady_duration>(deadline));
+		}
+		else
+		{
+			return m_slots->wait_until(std::chrono::steady_clock::now() + std::chrono::ceil<steady_duration>(deadline - Clock::now()));
+		}
+	}
+
+	/**
+	 * block() method temporarily mutes signal: emission returns without calling slots until unblock() is called.
+	 * Blocks are counted, so signal stays blocked until each block() call is paired with unblock().
+	 * Blocked emission of signal returning value returns combiner result without slot results.
+	 * See also signal_blocker class.
+	 */
+	void block() noexcept
+	{
+		m_slots->block();
+	}
+
+	/**
+	 * unblock() method cancels one previous block() call.
+	 */
+	void unblock() noexcept
+	{
+		m_slots->unblock();
+	}
+
+	/**
+	 * is_blocked() method returns true if signal emission is muted with block()
+	 */
+	[[nodiscard]] bool is_blocked() const noexcept
+	{
+		return m_slots->is_blocked();
+	}
+
+#if defined(LIBFASTSIGNALS_HAS_COROUTINES)
+	/**
+	 * next() method returns awaitable which resumes coroutine when signal is emitted next time:
+	 *  `auto [x, y] = co_await sig.next();`. Single argument is returned as is, no arguments - as void.
+	 * Coroutine is resumed on the emitting thread only once, even if signal is emitted on a few threads at once.
+	 * Awaitable keeps emission arguments in coroutine frame. Awaiting connects slot at front which is called once,
+	 *  as connect_once() does, so signal cannot be frozen while coroutine awaits it.
+	 */
+	[[nodiscard]] auto next()
+	{
+		static_assert(std::is_void_v<Return>, "Only signals returning void can be awaited");
+		return detail::next_emission_awaiter<signal_arg_t<Arguments>...>(m_slots, nullptr);
+	}
+
+	/**
+	 * next(executor) method returns awaitable which resumes coroutine on executor thread when signal is emitted next time.
+	 * If signal is emitted on other thread while coroutine suspends, coroutine continues without suspension.
+	 */
+	[[nodiscard]] auto next(executor& executor)
+	{
+		static_assert(std::is_void_v<Return>, "Only signals returning void can be awaited");
+		return detail::next_emission_awaiter<signal_arg_t<Arguments>...>(m_slots, &executor);
+	}
+
+	/**
+	 * stream(capacity) method returns async generator which yields every emission: `auto value = co_await stream.next();`.
+	 * Generator buffers up to capacity emissions and drops the oldest ones when buffer is full.
+	 */
+	[[nodiscard]] emission_stream<signal, signal_arg_t<Arguments>...> stream(std::size_t capacity)
+	{
+		static_assert(std::is_void_v<Return>, "Only signals returning void can be awaited");
+		return emission_stream<signal, signal_arg_t<Arguments>...>(*this, capacity);
+	}
+
+	/**
+	 * stream(capacity, executor) method returns async generator which resumes coroutine on executor thread.
+	 */
+	[[nodiscard]] emission_stream<signal, signal_arg_t<Arguments>...> stream(std::size_t capacity, executor& executor)
+	{
+		static_assert(std::is_void_v<Return>, "Only signals returning void can be awaited");
+		return emission_stream<signal, signal_arg_t<Arguments>...>(*this, capacity, &executor);
+	}
+#endif
+
 	/**
 	 * operator(args...) calls all slots connected to this signal.
 	 * Logically, it fires signal emission event.
 	 */
 	result_type operator()(signal_arg_t<Arguments>... args) const
 	{
-		return detail::signal_impl_ptr(m_slots)->invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+		return emit(m_slots, args...);
+	}
+
+	/**
+	 * emit_batch(items) method emits signal once for each item, where item is tuple of arguments.
+	 * Unlike loop of emissions, it looks up each slot once and calls it for all items before calling the next slot,
+	 *  so each slot sees all items in order, but slots are not interleaved. Slots connected with connect_batch()
+	 *  receive all items with single call.
+	 * If deferred_emission_scope defers signal, each item is recorded as separate emission.
+	 */
+	void emit_batch(span<const batch_item_type> items) const
+	{
+		static_assert_batch_emission();
+		if (items.empty() || m_slots->is_blocked())
+		{
+			return;
+		}
+		if (m_slots->is_deferred())
+		{
+			if (auto* deferred = detail::find_deferred_signal(m_slots.get()))
+			{
+				for (const auto& item : items)
+				{
+					std::apply([deferred](const auto&... args) {
+						static_cast<deferred_signal_type*>(deferred)->record(args...);
+					}, item);
+				}
+				return;
+			}
+		}
+		// Signal can be destroyed inside its slot, so emission keeps its own reference to slots.
+		detail::signal_impl_ptr(m_slots)->invoke_batch<signature_type, batch_item_type>(items);
+	}
+
+	/**
+	 * emit_async(args...) method copies arguments and calls slots on thread pool set by set_parallel_emission()
+	 *  without waiting for them. Without thread pool slots are called before emit_async returns.
+	 * Returned future becomes ready when all slots called, combiner receives slot results in connection order.
+	 * If any slot throws, future keeps the first exception and other slots are still called.
+	 * Note that slots connected with executor are only queued by emission, so future doesn't wait for their calls.
+	 */
+	std::future<result_type> emit_async(signal_arg_t<Arguments>... args) const
+	{
+		static_assert(((!std::is_lvalue_reference_v<Arguments> || std::is_const_v<std::remove_reference_t<Arguments>>)&&...),
+			"Asynchronous emission cannot pass arguments by non-const reference");
+		if (m_slots->is_blocked())
+		{
+			std::promise<result_type> blocked;
+			if constexpr (std::is_void_v<result_type>)
+			{
+				blocked.set_value();
+			}
+			else
+			{
+				blocked.set_value(combiner_type().get_value());
+			}
+			return blocked.get_future();
+		}
+		// Signal can be destroyed inside its slot, so emission keeps its own reference to slots.
+		return detail::signal_impl::invoke_async<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(detail::signal_impl_ptr(m_slots), args...);
 	}
 
 	void swap(signal& other) noexcept
@@ -127,15 +541,148 @@ public:
 		return [weakSlots = detail::signal_impl_weak_ptr(m_slots)](signal_arg_t<Arguments>... args) {
 			if (auto slots = weakSlots.lock())
 			{
-				return slots->invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+				return emit(slots, args...);
 			}
 		};
 	}
 
 private:
+	friend class deferred_emission_scope;
+	friend class signal_blocker;
+
+	using deferred_signal_type = detail::deferred_signal<signal_arg_t<Arguments>...>;
+
+	static result_type emit(const detail::signal_impl_ptr& slots, signal_arg_t<Arguments>... args)
+	{
+		if (slots->is_blocked())
+		{
+			// Blocked emission doesn't call slots, so combiner receives no results.
+			if constexpr (std::is_void_v<result_type>)
+			{
+				return;
+			}
+			else
+			{
+				return combiner_type().get_value();
+			}
+		}
+		if constexpr (std::is_void_v<result_type>)
+		{
+			// Emission is recorded if deferred_emission_scope of current thread defers this signal.
+			if (slots->is_deferred())
+			{
+				if (auto* deferred = detail::find_deferred_signal(slots.get()))
+				{
+					static_cast<deferred_signal_type*>(deferred)->record(args...);
+					return;
+				}
+			}
+		}
+		// Signal can be destroyed inside its slot, so emission keeps its own reference to slots.
+		return detail::signal_impl_ptr(slots)->invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+	}
+
+	static constexpr void static_assert_queued_connect() noexcept
+	{
+		static_assert(std::is_void_v<Return>, "Queued connect can only be used with slots returning void");
+		static_assert(((!std::is_lvalue_reference_v<Arguments> || std::is_const_v<std::remove_reference_t<Arguments>>)&&...),
+			"Queued connect cannot pass arguments by non-const reference");
+	}
+
+	static constexpr void static_assert_batch_emission() noexcept
+	{
+		static_assert(std::is_void_v<Return>, "Batch emission can only be used with slots returning void");
+		static_assert(((!std::is_lvalue_reference_v<Arguments> || std::is_const_v<std::remove_reference_t<Arguments>>)&&...),
+			"Batch emission cannot pass arguments by non-const reference");
+	}
+
 	detail::signal_impl_ptr m_slots;
 };
 
+/// Blocks signal while it exists, like Qt QSignalBlocker: emissions return without calling slots.
+/// Blocker keeps weak reference to signal, so it can outlive signal.
+class signal_blocker
+{
+public:
+	signal_blocker() noexcept = default;
+
+	template <class Signature, template <class T> class Combiner>
+	explicit signal_blocker(signal<Signature, Combiner>& signal) noexcept
+		: m_signal(signal.m_slots)
+	{
+		block();
+	}
+
+	signal_blocker(const signal_blocker&) = delete;
+	signal_blocker& operator=(const signal_blocker&) = delete;
+
+	signal_blocker(signal_blocker&& other) noexcept
+		: m_signal(std::move(other.m_signal))
+		, m_blocking(std::exchange(other.m_blocking, false))
+	{
+	}
+
+	signal_blocker& operator=(signal_blocker&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unblock();
+			m_signal = std::move(other.m_signal);
+			m_blocking = std::exchange(other.m_blocking, false);
+		}
+		return *this;
+	}
+
+	~signal_blocker()
+	{
+		unblock();
+	}
+
+	/**
+	 * block() method blocks signal again after unblock(), does nothing if blocker already blocks signal.
+	 */
+	void block() noexcept
+	{
+		if (m_blocking)
+		{
+			return;
+		}
+		if (auto signal = m_signal.lock())
+		{
+			signal->block();
+			m_blocking = true;
+		}
+	}
+
+	/**
+	 * unblock() method unblocks signal before blocker destroyed.
+	 */
+	void unblock() noexcept
+	{
+		if (!m_blocking)
+		{
+			return;
+		}
+		m_blocking = false;
+		if (auto signal = m_signal.lock())
+		{
+			signal->unblock();
+		}
+	}
+
+	/**
+	 * blocking() method returns true if blocker blocks signal
+	 */
+	[[nodiscard]] bool blocking() const noexcept
+	{
+		return m_blocking;
+	}
+
+private:
+	detail::signal_impl_weak_ptr m_signal;
+	bool m_blocking = false;
+};
+
 } // namespace is::signals
 
 namespace std
@@ -0,0 +1,280 @@
+#pragma once
+
+// Coroutine support requires C++20, in C++17 mode this header declares nothing.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#	if __has_include(<coroutine>)
+#		define LIBFASTSIGNALS_HAS_COROUTINES 1
+#	endif
+#endif
+
+#if defined(LIBFASTSIGNALS_HAS_COROUTINES)
+
+#	include "connection.h"
+#	include "executor.h"
+#	include "function.h"
+#	include "signal_impl.h"
+#	include "spin_mutex.h"
+#	include "type_traits.h"
+#	include <algorithm>
+#	include <atomic>
+#	include <coroutine>
+#	include <cstdint>
+#	include <mutex>
+#	include <optional>
+#	include <tuple>
+#	include <type_traits>
+#	include <vector>
+
+namespace is::signals
+{
+namespace detail
+{
+
+/// Type of value returned by co_await: nothing, single argument or tuple of arguments.
+template <class... Arguments>
+struct emission_value
+{
+	using type = std::tuple<std::decay_t<Arguments>...>;
+	using storage_type = type;
+};
+
+template <class Argument>
+struct emission_value<Argument>
+{
+	using type = std::decay_t<Argument>;
+	using storage_type = type;
+};
+
+template <>
+struct emission_value<>
+{
+	using type = void;
+	using storage_type = std::tuple<>;
+};
+
+template <class... Arguments>
+typename emission_value<Arguments...>::storage_type make_emission_value(Arguments... args)
+{
+	if constexpr (sizeof...(Arguments) == 1)
+	{
+		return (args, ...);
+	}
+	else
+	{
+		return typename emission_value<Arguments...>::storage_type(args...);
+	}
+}
+
+inline void resume_coroutine(std::coroutine_handle<> handle, executor* executor)
+{
+	if (executor)
+	{
+		executor->post([handle] {
+			handle.resume();
+		});
+	}
+	else
+	{
+		handle.resume();
+	}
+}
+
+/// Awaitable returned by signal::next(), lives in coroutine frame and keeps emission arguments there.
+/// Connects slot at front of signal on suspension, slot is disconnected by emission which calls it,
+///  so no other emission calls it and slot can point to awaiter.
+/// Emission which already started doesn't reach slots connected at front, so coroutine resumed inline,
+///  which awaits the same signal again, receives the next emission instead of the same one.
+template <class... Arguments>
+class next_emission_awaiter
+{
+public:
+	using value_type = typename emission_value<Arguments...>::type;
+
+	next_emission_awaiter(signal_impl_ptr signal, executor* executor) noexcept
+		: m_signal(std::move(signal))
+		, m_executor(executor)
+	{
+	}
+
+	next_emission_awaiter(const next_emission_awaiter&) = delete;
+	next_emission_awaiter& operator=(const next_emission_awaiter&) = delete;
+
+	// Coroutine can be destroyed while suspended, then emission must not resume it.
+	~next_emission_awaiter()
+	{
+		m_connection.disconnect();
+	}
+
+	bool await_ready() const noexcept
+	{
+		return false;
+	}
+
+	bool await_suspend(std::coroutine_handle<> handle)
+	{
+		m_handle = handle;
+		function<void(Arguments...)> slot = [this](Arguments... args) {
+			on_emit(args...);
+		};
+		const slot_key key = m_signal->add_limited(slot.release(), 1, connect_position::at_front);
+		m_connection = connection(m_signal->states(), key);
+		// Signal emitted on other thread before slot connected, so coroutine continues without suspension.
+		return m_status.exchange(awaiter_status::suspended, std::memory_order_acq_rel) != awaiter_status::fired;
+	}
+
+	value_type await_resume()
+	{
+		if constexpr (!std::is_void_v<value_type>)
+		{
+			return std::move(*m_value);
+		}
+	}
+
+private:
+	enum class awaiter_status
+	{
+		connecting,
+		suspended,
+		fired,
+	};
+
+	void on_emit(Arguments... args)
+	{
+		m_value.emplace(make_emission_value<Arguments...>(args...));
+		// Coroutine which didn't suspend yet destroys awaiter as soon as status changed, so members are read before.
+		const std::coroutine_handle<> handle = m_handle;
+		executor* const resumeExecutor = m_executor;
+		if (m_status.exchange(awaiter_status::fired, std::memory_order_acq_rel) == awaiter_status::suspended)
+		{
+			resume_coroutine(handle, resumeExecutor);
+		}
+	}
+
+	signal_impl_ptr m_signal;
+	executor* m_executor = nullptr;
+	std::coroutine_handle<> m_handle;
+	std::optional<typename emission_value<Arguments...>::storage_type> m_value;
+	std::atomic<awaiter_status> m_status = awaiter_status::connecting;
+	connection m_connection;
+};
+
+} // namespace detail
+
+/// Async generator which yields every emission of signal to coroutine: `auto value = co_await stream.next();`
+/// Stream connects to signal on construction and buffers up to capacity emissions which coroutine didn't take yet,
+///  when buffer is full it drops the oldest emission.
+/// Create stream with signal::stream(capacity) method. Stream must not be destroyed while coroutine awaits it.
+template <class Signal, class... Arguments>
+class emission_stream
+{
+public:
+	using value_type = typename detail::emission_value<Arguments...>::type;
+
+	emission_stream(Signal& signal, std::size_t capacity, executor* executor = nullptr)
+		: m_executor(executor)
+		, m_items(std::max(capacity, std::size_t(1)))
+	{
+		m_connection = signal.connect([this](Arguments... args) {
+			on_emit(args...);
+		});
+	}
+
+	emission_stream(const emission_stream&) = delete;
+	emission_stream& operator=(const emission_stream&) = delete;
+
+	/**
+	 * next() method returns awaitable which yields the oldest buffered emission or waits for the next one.
+	 * Only one coroutine can await stream at a time.
+	 */
+	[[nodiscard]] auto next() noexcept
+	{
+		struct awaiter
+		{
+			emission_stream& stream;
+
+			bool await_ready() const noexcept
+			{
+				std::lock_guard lock(stream.m_mutex);
+				return stream.m_count != 0;
+			}
+
+			bool await_suspend(std::coroutine_handle<> handle) noexcept
+			{
+				std::lock_guard lock(stream.m_mutex);
+				if (stream.m_count != 0)
+				{
+					return false;
+				}
+				stream.m_waiting = handle;
+				return true;
+			}
+
+			value_type await_resume()
+			{
+				return stream.pop();
+			}
+		};
+		return awaiter{ *this };
+	}
+
+	/**
+	 * dropped_count() method returns number of emissions dropped because buffer was full
+	 */
+	[[nodiscard]] uint64_t dropped_count() const noexcept
+	{
+		return m_droppedCount.load(std::memory_order_relaxed);
+	}
+
+private:
+	using storage_type = typename detail::emission_value<Arguments...>::storage_type;
+
+	void on_emit(Arguments... args)
+	{
+		std::coroutine_handle<> waiting;
+		{
+			std::lock_guard lock(m_mutex);
+			if (m_count == m_items.size())
+			{
+				m_items[m_first].reset();
+				m_first = (m_first + 1) % m_items.size();
+				--m_count;
+				m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+			m_items[(m_first + m_count) % m_items.size()].emplace(detail::make_emission_value<Arguments...>(args...));
+			++m_count;
+			std::swap(waiting, m_waiting);
+		}
+		if (waiting)
+		{
+			detail::resume_coroutine(waiting, m_executor);
+		}
+	}
+
+	value_type pop()
+	{
+		std::lock_guard lock(m_mutex);
+		auto& item = m_items[m_first];
+		storage_type value = std::move(*item);
+		item.reset();
+		m_first = (m_first + 1) % m_items.size();
+		--m_count;
+		if constexpr (!std::is_void_v<value_type>)
+		{
+			return value;
+		}
+	}
+
+	executor* m_executor = nullptr;
+	detail::spin_mutex m_mutex;
+	// Ring buffer of emissions, allocated once on construction.
+	std::vector<std::optional<storage_type>> m_items;
+	std::size_t m_first = 0;
+	std::size_t m_count = 0;
+	std::coroutine_handle<> m_waiting;
+	std::atomic<uint64_t> m_droppedCount = 0;
+	scoped_connection m_connection;
+};
+
+} // namespace is::signals
+
+#endif
@@ -1,56 +1,589 @@
 #pragma once
 
+#include "async_emission.h"
+#include "cache_line.h"
+#include "combiners.h"
+#include "connection_table.h"
+#include "emission_waiters.h"
+#include "function.h"
 #include "function_detail.h"
+#include "signal_policies.h"
+#include "slot_states.h"
+#include "span.h"
 #include "spin_mutex.h"
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
+namespace is::signals
+{
+class thread_pool;
+} // namespace is::signals
+
 namespace is::signals::detail
 {
 
-class signal_impl
+template <size_t ShardCount>
+class sharded_signal_impl;
+
+class LIBFASTSIGNALS_CACHE_LINE_ALIGN signal_impl final : public slot_owner
 {
 public:
-	uint64_t add(packed_function fn);
+	signal_impl();
+	signal_impl(const signal_impl&) = delete;
+	signal_impl& operator=(const signal_impl&) = delete;
+
+	// Invalidates connections and compact connection handles of this signal.
+	~signal_impl();
+
+	slot_key add(packed_function fn);
+
+	// Takes slot id from counter shared by a few signals, so slot ids are ordered across these signals.
+	slot_key add(packed_function fn, std::atomic<uint64_t>& sharedNextId);
+
+	// Connects slot which is called before slots without group, see signal::connect(slot, position).
+	slot_key add_ungrouped(packed_function fn, connect_position position);
+
+	// Connects slot of group: groups are called in ascending order before slots connected at back without group.
+	slot_key add_to_group(packed_function fn, int group, connect_position position);
+
+	// Connects slot which is disconnected by emission after given number of calls.
+	// Slot connected at front is called before other slots, as with add_ungrouped().
+	slot_key add_limited(packed_function fn, uint64_t callCount, connect_position position = connect_position::at_back);
+
+	// Returns states of connections created with add(), which connections keep after signal destroyed.
+	const slot_states_ptr& states() const noexcept;
 
-	void remove(uint64_t id) noexcept;
+	// Connects slot which is disconnected with compact connection handle, see connection_handle.h.
+	connection_handle_data add_with_handle(packed_function fn);
+
+	// Connects a few slots with one lock and one reallocation, handles of slots are appended to given vector.
+	void add_with_handles(span<packed_function> fns, std::vector<connection_handle_data>& handles);
+
+	// Called by slot states: removed slots and retired snapshots are moved into given storage,
+	//  so caller destroys them after unlocking states.
+	void remove(slot_key key, packed_function& removedFunction, released_storage_ptr& releasedStorage) noexcept final;
+
+	// Removes a few slots with one lock and one compaction pass, keys must be sorted by id.
+	// Storage for removed slots should be reserved by caller.
+	void remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& releasedStorage) noexcept final;
+
+	// Called by connection table under its lock, so signal destructor waits until remove_with_handle() is called.
+	void begin_remove_with_handle() noexcept;
+
+	// Called by connection table after unlocking it: removes slot connected with add_with_handle(),
+	//  removed slot is moved into given function, so caller destroys it after signal unlocked.
+	// Signal can be destroyed once call is finished, so removed slot cannot be destroyed by signal itself.
+	void remove_with_handle(uint64_t id, packed_function& removedFunction) noexcept;
 
 	void remove_all() noexcept;
 
+	// Disconnects all slots equal to given callable, see signal::disconnect(slot).
+	// Slots are found by hash of callable and copied under lock, then compared with it after unlocking.
+	template <class Signature, class Callable>
+	void remove_equal(const Callable& callable)
+	{
+		const size_t hash = packed_function::get_identity_hash_of<Signature>(callable);
+		std::vector<equal_candidate> candidates;
+		{
+			std::unique_lock lock(m_mutex);
+			// Storage for found slots is allocated while mutex unlocked.
+			for (size_t count = m_identities.count(hash); count > candidates.capacity(); count = m_identities.count(hash))
+			{
+				lock.unlock();
+				candidates.reserve(count);
+				lock.lock();
+			}
+
+			const auto range = m_identities.equal_range(hash);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				if (const packed_function* slot = find_slot_locked(it->second.id))
+				{
+					const connection_table_ref* ref = find_handle_ref_locked(it->second.id);
+					candidates.push_back({ it->second, ref ? ref->handle : connection_handle_data{}, *slot });
+				}
+			}
+		}
+
+		// User operator== is called without lock, so it can use this signal.
+		std::vector<slot_key> keys;
+		keys.reserve(candidates.size());
+		for (const equal_candidate& candidate : candidates)
+		{
+			if (!candidate.function.equals<Signature>(callable))
+			{
+				continue;
+			}
+			if (candidate.handle.index != 0)
+			{
+				// Slots are removed as their connections disconnect them, so states and handles are released too.
+				// Slot which was disconnected meanwhile is ignored, since its handle is stale.
+				connection_table::instance().disconnect(candidate.handle);
+			}
+			else
+			{
+				keys.push_back(candidate.key);
+			}
+		}
+
+		std::sort(keys.begin(), keys.end(), [](const slot_key& lhs, const slot_key& rhs) {
+			return lhs.id < rhs.id;
+		});
+		if (!keys.empty())
+		{
+			m_states->disconnect(keys);
+		}
+	}
+
 	size_t count() const noexcept;
 
+	void reserve(size_t capacity);
+
+	void shrink_to_fit() noexcept;
+
+	void set_shrink_policy(shrink_policy policy) noexcept;
+
+	size_t capacity() const noexcept;
+
+	void freeze(freeze_policy policy);
+
+	void unfreeze() noexcept;
+
+	bool is_frozen() const noexcept;
+
+	void set_parallel_emission(std::shared_ptr<thread_pool> pool, size_t slotsPerTask) noexcept;
+
+	bool wait_until(std::chrono::steady_clock::time_point deadline) const;
+
+	void wait() const;
+
+	void block() noexcept;
+
+	void unblock() noexcept;
+
+	bool is_blocked() const noexcept
+	{
+		return m_blockCount.load(std::memory_order_relaxed) != 0;
+	}
+
+	// Deferred signal checks thread-local deferred_emission_scope on each emission.
+	void add_deferral() noexcept;
+
+	void remove_deferral() noexcept;
+
+	bool is_deferred() const noexcept
+	{
+		return m_deferralCount.load(std::memory_order_relaxed) != 0;
+	}
+
 	template <class Combiner, class Result, class Signature, class... Args>
-	Result invoke(Args... args) const
+	Result invoke(Args... args)
 	{
+		// Wakes up threads which wait for emission after all slots called, even if slot throws.
+		const waiters_notifier notifier{ *m_waiters };
+
+		if (m_parallelEmission.load(std::memory_order_relaxed))
+		{
+			return invoke_parallel<Combiner, Result, Signature, Args...>(args...);
+		}
+
+		// Frozen slots never change, so we can call them without locks and copies.
+		if (m_frozen.load(std::memory_order_acquire))
+		{
+			const frozen_reader reader(*this);
+			if (const auto* frozen = reader.slots())
+			{
+				if constexpr (std::is_same_v<Result, void>)
+				{
+					for (const auto& slot : *frozen)
+					{
+						slot.call<Signature>(std::forward<Args>(args)...);
+					}
+					return;
+				}
+				else
+				{
+					Combiner combiner;
+					for (const auto& slot : *frozen)
+					{
+						combiner(slot.call<Signature>(std::forward<Args>(args)...));
+					}
+					return combiner.get_value();
+				}
+			}
+		}
+
 		packed_function slot;
-		size_t slotIndex = 0;
-		uint64_t slotId = 1;
+		slot_cursor cursor;
 
 		if constexpr (std::is_same_v<Result, void>)
 		{
-			while (get_next_slot(slot, slotIndex, slotId))
+			while (get_next_slot(slot, cursor))
 			{
-				slot.get<Signature>()(std::forward<Args>(args)...);
+				slot.call<Signature>(std::forward<Args>(args)...);
 			}
 		}
 		else
 		{
 			Combiner combiner;
-			while (get_next_slot(slot, slotIndex, slotId))
+			while (get_next_slot(slot, cursor))
 			{
-				combiner(slot.get<Signature>()(std::forward<Args>(args)...));
+				combiner(slot.call<Signature>(std::forward<Args>(args)...));
 			}
 			return combiner.get_value();
 		}
 	}
 
+	// Calls each slot for all items before calling the next slot, so slots are looked up once per batch.
+	template <class Signature, class Item>
+	void invoke_batch(span<const Item> items)
+	{
+		const waiters_notifier notifier{ *m_waiters };
+
+		auto callSlot = [&items](const packed_function& slot) {
+			if (slot.call_batch<Signature>(&items))
+			{
+				return;
+			}
+			for (const Item& item : items)
+			{
+				std::apply([&slot](const auto&... args) {
+					slot.call<Signature>(args...);
+				}, item);
+			}
+		};
+
+		if (m_frozen.load(std::memory_order_acquire))
+		{
+			const frozen_reader reader(*this);
+			if (const auto* frozen = reader.slots())
+			{
+				for (const auto& slot : *frozen)
+				{
+					callSlot(slot);
+				}
+				return;
+			}
+		}
+
+		packed_function slot;
+		slot_cursor cursor;
+		while (get_next_slot(slot, cursor))
+		{
+			callSlot(slot);
+		}
+	}
+
+	// Calls slots on parallel emission pool if it's set, or on calling thread otherwise.
+	// Takes reference to signal, so slot can destroy signal, and waiters are notified after the last slot called.
+	template <class Combiner, class Result, class Signature, class... Args>
+	static std::future<Result> invoke_async(const std::shared_ptr<signal_impl>& self, Args... args)
+	{
+		parallel_emission emission;
+		self->get_parallel_emission(emission);
+		// Tasks may outlive signal, so they can't use frozen slots in-place.
+		std::vector<packed_function> slots = (emission.slots == &emission.copiedSlots)
+			? std::move(emission.copiedSlots)
+			: *emission.slots;
+
+		const size_t count = slots.size();
+		const size_t slotsPerTask = emission.slotsPerTask;
+		const bool runInPool = emission.pool && count != 0;
+		const size_t taskCount = runInPool ? (count + slotsPerTask - 1) / slotsPerTask : 1;
+		// Tasks may outlive signal too, so they keep only its waiters and never destroy signal on pool thread.
+		auto state = std::make_shared<async_emission<Combiner, Result, Signature, Args...>>(std::move(slots), taskCount, self->m_waiters, args...);
+		auto future = state->get_future();
+
+		if (!runInPool)
+		{
+			state->run(0, count);
+			return future;
+		}
+		for (size_t begin = 0; begin < count; begin += slotsPerTask)
+		{
+			const size_t end = std::min(begin + slotsPerTask, count);
+			try
+			{
+				self->post_parallel_task(emission, [state, begin, end] {
+					state->run(begin, end);
+				});
+			}
+			catch (const std::bad_alloc& /*e*/)
+			{
+				// Task is not queued, so call its slots here, otherwise future never becomes ready.
+				state->run(begin, end);
+			}
+		}
+		return future;
+	}
+
 private:
-	bool get_next_slot(packed_function& slot, size_t& expectedIndex, uint64_t& nextId) const;
+	using frozen_slots = std::vector<packed_function>;
 
-	mutable spin_mutex m_mutex;
+	// Slots copied by freeze(). Snapshot replaced by unfreeze is retired into list,
+	//  since emissions which started before unfreeze may still iterate it.
+	struct frozen_snapshot final : released_storage
+	{
+		~frozen_snapshot() override
+		{
+			// List is destroyed in loop, so long list doesn't overflow stack.
+			for (auto next = std::move(nextRetired); next; next = std::move(next->nextRetired))
+			{
+			}
+		}
+
+		frozen_slots slots;
+		std::unique_ptr<frozen_snapshot> nextRetired;
+	};
+	using frozen_snapshot_ptr = std::unique_ptr<frozen_snapshot>;
+
+	// Counter of emissions which iterate frozen slots, each thread uses one of a few counters on separate cache lines,
+	//  so emitting threads don't modify the same cache line.
+	struct alignas(cache_line_size) frozen_reader_count
+	{
+		std::atomic<uint32_t> value = 0;
+	};
+	static constexpr size_t frozen_reader_count_number = 8;
+
+	// Counts emission which iterates frozen slots, so retired snapshots are released when no emission uses them.
+	// Should be created only after signal was seen frozen, since counters are allocated by the first freeze().
+	class frozen_reader
+	{
+	public:
+		explicit frozen_reader(signal_impl& signal) noexcept
+			: m_signal(signal)
+			, m_count(signal.m_frozenReaders[get_reader_count_index()].value)
+		{
+			// Counter is incremented before pointer loaded, see take_unused_snapshots_locked().
+			m_count.fetch_add(1, std::memory_order_seq_cst);
+			m_slots = m_signal.m_frozen.load(std::memory_order_seq_cst);
+		}
+
+		frozen_reader(const frozen_reader&) = delete;
+		frozen_reader& operator=(const frozen_reader&) = delete;
+
+		~frozen_reader()
+		{
+			m_signal.release_frozen_reader(m_count);
+		}
+
+		const frozen_slots* slots() const noexcept
+		{
+			return m_slots;
+		}
+
+	private:
+		static size_t get_reader_count_index() noexcept
+		{
+			// Threads take counters in turn, so a few emitting threads use different counters.
+			static std::atomic<size_t> nextIndex = 0;
+			thread_local const size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % frozen_reader_count_number;
+			return index;
+		}
+
+		signal_impl& m_signal;
+		std::atomic<uint32_t>& m_count;
+		const frozen_slots* m_slots = nullptr;
+	};
+
+	// Slots and thread pool used by one parallel emission.
+	struct parallel_emission
+	{
+		std::shared_ptr<thread_pool> pool;
+		size_t slotsPerTask = 1;
+		// Keeps frozen slots alive while emission uses them.
+		std::optional<frozen_reader> reader;
+		// Points either to frozen slots or to copied slots.
+		const std::vector<packed_function>* slots = nullptr;
+		std::vector<packed_function> copiedSlots;
+		// Slots which made their last call, destroyed after mutex unlocked.
+		std::vector<packed_function> retiredSlots;
+	};
+
+	template <class Combiner, class Result, class Signature, class... Args>
+	Result invoke_parallel(Args... args)
+	{
+		parallel_emission emission;
+		get_parallel_emission(emission);
+		const auto& slots = *emission.slots;
+
+		if constexpr (std::is_same_v<Result, void>)
+		{
+			run_parallel_emission(emission, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+				{
+					slots[i].call<Signature>(std::forward<Args>(args)...);
+				}
+			});
+		}
+		else
+		{
+			// Slot results stored by slot index, so combiner receives them in connection order.
+			using slot_result = std::invoke_result_t<function_proxy<Signature>&, Args...>;
+			concurrent_combiner<Combiner, slot_result> results(slots.size());
+			run_parallel_emission(emission, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i)
+				{
+					results.set(i, slots[i].call<Signature>(std::forward<Args>(args)...));
+				}
+			});
+			return results.get_value();
+		}
+	}
+
+	struct waiters_notifier
+	{
+		~waiters_notifier()
+		{
+			waiters.notify();
+		}
+
+		const emission_waiters& waiters;
+	};
+
+	// Slots of one group or slots connected at front without group, which are called before slots of main storage.
+	// Slots are stored in connection order, so connect never moves slots of other segments.
+	// Segment which keeps slots connected at front is emitted in reverse order.
+	// Slot copied by remove_equal() for comparison, handle index is zero if slot has no connection handle.
+	struct equal_candidate
+	{
+		slot_key key;
+		connection_handle_data handle;
+		packed_function function;
+	};
+
+	struct slot_segment
+	{
+		uint64_t key = 0;
+		std::vector<packed_function> functions;
+		std::vector<uint64_t> ids;
+	};
+
+	// Position of emission: segments are visited in key order, then slots of main storage.
+	struct slot_cursor
+	{
+		uint64_t segmentKey = 0;
+		// Expected index of the next slot in current segment or in main storage.
+		size_t index = 0;
+		// In forward order the next slot has id not less than nextId, in reverse order it has id less than nextId.
+		// Zero means that emission didn't start current segment yet.
+		uint64_t nextId = 0;
+	};
+
+	// Remaining calls of slot connected with connect_once() or connect_n().
+	struct call_limit
+	{
+		uint64_t slotId = 0;
+		uint64_t remainingCalls = 0;
+		uint32_t stateIndex = 0;
+	};
+
+	// Slots storage which should be destroyed after mutex unlocked.
+	struct released_slots
+	{
+		std::vector<packed_function> functions;
+		std::vector<uint64_t> ids;
+		frozen_snapshot_ptr snapshots;
+		std::vector<slot_segment> segments;
+		std::vector<call_limit> callLimits;
+		std::vector<connection_table_ref> handleRefs;
+	};
+
+	using identity_map = std::unordered_multimap<size_t, slot_key>;
+
+	template <size_t ShardCount>
+	friend class sharded_signal_impl;
+
+	bool get_next_slot(packed_function& slot, size_t& expectedIndex, uint64_t& nextId,
+		uint64_t maxId = std::numeric_limits<uint64_t>::max());
+	bool get_next_slot(packed_function& slot, slot_cursor& cursor);
+	bool get_next_main_slot_locked(packed_function& slot, size_t& expectedIndex, uint64_t& nextId, uint64_t maxId);
+	bool get_next_segment_slot_locked(packed_function& slot, slot_cursor& cursor);
+	// Copies slot of segment, or moves it out if it made its last call. Returns true if slot was removed from segment.
+	bool take_segment_slot_locked(packed_function& slot, std::vector<slot_segment>::iterator segment, size_t index) noexcept;
+	slot_key add_to_segment(packed_function fn, uint64_t segmentKey, uint64_t callCount = 0);
+	void prepare_connect_locked(released_slots& released);
+	// Removes slot from segments, returns false if there is no such slot.
+	bool remove_from_segments_locked(slot_key key, packed_function& removedFunction) noexcept;
+	// Returns slot with given id from main storage or segments, or nullptr if there is no such slot.
+	const packed_function* find_slot_locked(uint64_t id) const noexcept;
+	const connection_table_ref* find_handle_ref_locked(uint64_t id) const noexcept;
+	// Removes index entry of comparable slot, called when slot leaves storage.
+	void erase_identity_locked(uint64_t id, const packed_function& fn) noexcept;
+	// Index entry is allocated before locking signal and inserted under lock, index is stored as slot id.
+	static void prepare_identity_node(const packed_function& fn, uint64_t index, identity_map& nodes);
+	identity_map::iterator insert_identity_locked(identity_map& node);
+	// Copies slots of segments and main storage in emission order.
+	void copy_slots_locked(std::vector<packed_function>& slots) const;
+	// Slot connected with compact handle doesn't take entry of slot states, zero callCount means unlimited slot.
+	slot_key add_impl(packed_function fn, std::atomic<uint64_t>* sharedNextId, const connection_handle_data* handle = nullptr, uint64_t callCount = 0);
+	// Returns id of the first connected slot, other slots have sequential ids.
+	uint64_t add_range_impl(span<packed_function> fns, span<const connection_handle_data> handles);
+	// Counts call of slot with limited number of calls, returns true if it was the last call.
+	bool count_call_locked(uint64_t id) noexcept;
+	void erase_call_limit_locked(uint64_t id) noexcept;
+	// Counts call of each slot copied by parallel emission and moves out slots which made their last call.
+	void retire_called_slots_locked(std::vector<packed_function>& retiredSlots);
+	void remove_locked(std::unique_lock<spin_mutex>& lock, slot_key key, packed_function& removedFunction, released_slots& released) noexcept;
+	void get_parallel_emission(parallel_emission& emission);
+	void run_parallel_emission(const parallel_emission& emission, const function<void(size_t, size_t)>& body) const;
+	void post_parallel_task(const parallel_emission& emission, function<void()> task) const;
+	void unfreeze_locked(released_slots& released) noexcept;
+	void release_frozen_reader(std::atomic<uint32_t>& count) noexcept;
+	// Moves retired snapshots into given pointer if no emission iterates frozen slots.
+	void take_unused_snapshots_locked(frozen_snapshot_ptr& snapshots) noexcept;
+	size_t capacity_locked() const noexcept;
+	void reallocate_locked(std::unique_lock<spin_mutex>& lock, size_t capacity, released_slots& released);
+	void shrink_locked(std::unique_lock<spin_mutex>& lock, released_slots& released) noexcept;
+
+	// Lock has its own cache line since waiting threads spin on it.
+	LIBFASTSIGNALS_CACHE_LINE_ALIGN mutable spin_mutex m_mutex;
+
+	// Data read by each emission.
+	// Points to slots of m_snapshot while signal is frozen, nullptr otherwise.
+	LIBFASTSIGNALS_CACHE_LINE_ALIGN std::atomic<const frozen_slots*> m_frozen = nullptr;
+	std::atomic<bool> m_hasRetiredSnapshots = false;
+	// Allocated by the first freeze() before m_frozen is set and kept until signal destroyed.
+	std::unique_ptr<frozen_reader_count[]> m_frozenReaders;
 	std::vector<packed_function> m_functions;
 	std::vector<uint64_t> m_ids;
-	uint64_t m_nextId = 1;
+	std::atomic<bool> m_parallelEmission = false;
+	// Shared with asynchronous emissions, which notify waiters after signal destroyed.
+	const std::shared_ptr<const emission_waiters> m_waiters;
+	std::atomic<uint32_t> m_deferralCount = 0;
+	std::atomic<uint32_t> m_blockCount = 0;
+
+	// Data modified by connect and disconnect.
+	LIBFASTSIGNALS_CACHE_LINE_ALIGN uint64_t m_nextId = 1;
+	size_t m_reservedCapacity = 0;
+	shrink_policy m_shrinkPolicy = shrink_policy::automatic;
+	freeze_policy m_freezePolicy = freeze_policy::unfreeze_on_change;
+	std::shared_ptr<thread_pool> m_parallelPool;
+	size_t m_slotsPerTask = 1;
+	// Compact connection handles sorted by slot id, m_hasHandles is set by the first handle and never reset.
+	std::vector<connection_table_ref> m_handleRefs;
+	std::atomic<bool> m_hasHandles = false;
+	// Number of connection handles which are disconnecting slots of this signal without table lock.
+	std::atomic<uint32_t> m_handleRemovals = 0;
+	// Slots with group or connected at front sorted by segment key, usually empty.
+	std::vector<slot_segment> m_segments;
+	// Slots with limited number of calls sorted by slot id, usually empty.
+	std::vector<call_limit> m_callLimits;
+	// Keys of comparable slots by hash of callable, such as function pointers and delegates.
+	identity_map m_identities;
+	const slot_states_ptr m_states;
+	frozen_snapshot_ptr m_snapshot;
+	// Snapshots replaced by unfreeze, released when no emission iterates frozen slots.
+	frozen_snapshot_ptr m_retiredSnapshots;
 };
 
 using signal_impl_ptr = std::shared_ptr<signal_impl>;
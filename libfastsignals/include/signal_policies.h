@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+namespace is::signals
+{
+
+/// Defines what happens when frozen signal is modified.
+enum class freeze_policy
+{
+	/// Connect and disconnect silently unfreeze signal.
+	unfreeze_on_change,
+	/// Connect throws std::logic_error, disconnect still unfreezes signal since it cannot throw.
+	throw_on_connect,
+};
+
+/// Defines where slot is placed among slots of the same group, see signal::connect(group, slot, position).
+enum class connect_position
+{
+	/// Slot is called after slots which are already connected.
+	at_back,
+	/// Slot is called before slots which are already connected.
+	at_front,
+};
+
+/// Defines when signal returns memory of disconnected slots.
+enum class shrink_policy
+{
+	/// Memory returned only by shrink_to_fit() call.
+	manual,
+	/// Memory returned on disconnect when less than a quarter of storage is used,
+	///  but storage never shrinks below capacity requested with reserve().
+	automatic,
+};
+
+/// Defines what queued connection does when executor didn't deliver too many emissions to its slot yet.
+enum class overflow_policy
+{
+	/// Emitting thread waits until executor delivers the oldest pending emission.
+	block,
+	/// New emission is dropped.
+	drop_newest,
+	/// The oldest pending emission is dropped.
+	drop_oldest,
+	/// New emission replaces pending one, so slot receives only the latest arguments. Capacity is ignored.
+	coalesce,
+};
+
+/// Defines which emissions recorded by deferred_emission_scope are delivered on scope exit.
+enum class deferral_policy
+{
+	/// Signal is emitted once with arguments of the last recorded emission.
+	last,
+	/// All recorded emissions are delivered in order.
+	all,
+};
+
+/// Limits number of emissions which wait for delivery to slot of queued connection.
+struct queue_limit
+{
+	std::size_t capacity = 1;
+	overflow_policy policy = overflow_policy::block;
+};
+
+} // namespace is::signals
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "function_detail.h"
+#include "span.h"
+#include "spin_mutex.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace is::signals::detail
+{
+
+// Identifies slot of connection: id is unique within signal, index points to entry of slot states.
+struct slot_key
+{
+	uint64_t id = 0;
+	uint32_t index = 0;
+};
+
+/// Signal data which keeps copies of removed slots, e.g. retired snapshots of frozen signal.
+class released_storage
+{
+public:
+	virtual ~released_storage() = default;
+};
+
+using released_storage_ptr = std::unique_ptr<released_storage>;
+
+/// Slots storage of signal which removes slots on disconnect, implemented by signal_impl and unordered_signal_impl.
+/// Removed slots and released storage are moved to caller, so they are destroyed after all locks released.
+class slot_owner
+{
+public:
+	virtual void remove(slot_key key, packed_function& removedFunction, released_storage_ptr& releasedStorage) noexcept = 0;
+	// Keys must be sorted by id.
+	virtual void remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& releasedStorage) noexcept = 0;
+
+protected:
+	~slot_owner() = default;
+};
+
+/// Keeps id of connected slot in entry of each connection, so connection::connected() is one atomic load.
+/// Entries are modified under signal lock and read without locks. Chunks of entries never move,
+///  and connections share ownership of states, so states are readable after signal destroyed.
+/// Signal detaches states on destruction: then all entries are released and disconnect does nothing.
+class slot_states
+{
+public:
+	using chunk_ptr = std::unique_ptr<std::atomic<uint64_t>[]>;
+
+	explicit slot_states(slot_owner& signal) noexcept;
+	slot_states(const slot_states&) = delete;
+	slot_states& operator=(const slot_states&) = delete;
+	~slot_states();
+
+	bool is_connected(slot_key key) const noexcept
+	{
+		return entry(key.index).load(std::memory_order_acquire) == key.id;
+	}
+
+	// Removes slot from signal unless signal is destroyed. Slot is destroyed after all locks released.
+	void disconnect(slot_key key) noexcept;
+
+	// Removes a few slots with one signal lock, keys must be sorted by id.
+	void disconnect(span<const slot_key> keys) noexcept;
+
+	// Called by signal destructor: waits for running disconnect calls and releases all entries.
+	void detach() noexcept;
+
+	// Methods below are called under signal lock.
+
+	// Returns false if the next chunk should be added before acquire().
+	bool has_free_entry() const noexcept;
+	size_t chunk_count() const noexcept;
+	// Allocates chunk with given index, called without locks.
+	static chunk_ptr allocate_chunk(size_t chunkIndex);
+	void add_chunk(chunk_ptr chunk) noexcept;
+	// Adds chunk if there is no free entry, chunk is allocated while signal lock is released.
+	// Chunk which wasn't used because other thread added chunk first is kept in spareChunk.
+	void reserve_entry(std::unique_lock<spin_mutex>& signalLock, chunk_ptr& spareChunk);
+	uint32_t acquire(uint64_t id) noexcept;
+	// Releases entry only if it still belongs to slot with given id, so slot without entry can pass any index.
+	void release(slot_key key) noexcept;
+	void release_all() noexcept;
+
+private:
+	// Chunk k keeps entries with indexes [first_chunk_size * (2^k - 1), first_chunk_size * (2^(k+1) - 1)),
+	//  so index of entry fits 32 bits.
+	static constexpr size_t first_chunk_size = 16;
+	static constexpr size_t max_chunk_count = 27;
+	// Released entry keeps this bit and index of the next free entry plus one, so it never equals slot id.
+	static constexpr uint64_t free_entry_bit = uint64_t(1) << 63;
+
+	std::atomic<uint64_t>& entry(uint32_t index) const noexcept
+	{
+		const size_t block = index / first_chunk_size + 1;
+		size_t chunk = 0;
+		while ((block >> (chunk + 1)) != 0)
+		{
+			++chunk;
+		}
+		const size_t firstIndex = first_chunk_size * ((size_t(1) << chunk) - 1);
+		return m_chunks[chunk].load(std::memory_order_acquire)[index - firstIndex];
+	}
+
+	// Guards m_signal, taken before signal lock.
+	spin_mutex m_signalMutex;
+	slot_owner* m_signal = nullptr;
+
+	std::array<std::atomic<std::atomic<uint64_t>*>, max_chunk_count> m_chunks = {};
+	size_t m_chunkCount = 0;
+	// Number of entries which were acquired at least once.
+	uint32_t m_usedCount = 0;
+	// Index of the first released entry plus one, zero if there is no released entries.
+	uint32_t m_freeHead = 0;
+};
+
+using slot_states_ptr = std::shared_ptr<slot_states>;
+
+} // namespace is::signals::detail
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace is::signals
+{
+
+/// Non-owning view of contiguous sequence, minimal replacement of C++20 std::span.
+/// Used to pass batch of emissions, see signal::emit_batch().
+template <class T>
+class span
+{
+public:
+	using element_type = T;
+	using value_type = std::remove_cv_t<T>;
+	using iterator = T*;
+
+	span() noexcept = default;
+
+	span(T* data, std::size_t size) noexcept
+		: m_data(data)
+		, m_size(size)
+	{
+	}
+
+	template <class U, class Allocator, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+	span(std::vector<U, Allocator>& items) noexcept
+		: m_data(items.data())
+		, m_size(items.size())
+	{
+	}
+
+	template <class U, class Allocator, class = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+	span(const std::vector<U, Allocator>& items) noexcept
+		: m_data(items.data())
+		, m_size(items.size())
+	{
+	}
+
+	template <class U, std::size_t Size, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+	span(std::array<U, Size>& items) noexcept
+		: m_data(items.data())
+		, m_size(Size)
+	{
+	}
+
+	template <class U, std::size_t Size, class = std::enable_if_t<std::is_convertible_v<const U (*)[], T (*)[]>>>
+	span(const std::array<U, Size>& items) noexcept
+		: m_data(items.data())
+		, m_size(Size)
+	{
+	}
+
+	[[nodiscard]] T* data() const noexcept
+	{
+		return m_data;
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept
+	{
+		return m_size;
+	}
+
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return m_size == 0;
+	}
+
+	[[nodiscard]] T& operator[](std::size_t index) const noexcept
+	{
+		return m_data[index];
+	}
+
+	[[nodiscard]] iterator begin() const noexcept
+	{
+		return m_data;
+	}
+
+	[[nodiscard]] iterator end() const noexcept
+	{
+		return m_data + m_size;
+	}
+
+private:
+	T* m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+} // namespace is::signals
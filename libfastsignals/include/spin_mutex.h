@@ -15,24 +15,28 @@ public:
 
 	inline bool try_lock() noexcept
 	{
-		return !m_busy.test_and_set(std::memory_order_acquire);
+		return !m_busy.exchange(true, std::memory_order_acquire);
 	}
 
 	inline void lock() noexcept
 	{
 		while (!try_lock())
 		{
-			/* do nothing */;
+			// Wait using plain loads, so waiting threads don't steal cache line from lock owner.
+			while (m_busy.load(std::memory_order_relaxed))
+			{
+				/* do nothing */;
+			}
 		}
 	}
 
 	inline void unlock() noexcept
 	{
-		m_busy.clear(std::memory_order_release);
+		m_busy.store(false, std::memory_order_release);
 	}
 
 private:
-	std::atomic_flag m_busy = ATOMIC_FLAG_INIT;
+	std::atomic<bool> m_busy = ATOMIC_VAR_INIT(false);
 };
 
 } // namespace is::signals::detail
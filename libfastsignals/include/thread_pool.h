@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cache_line.h"
+#include "function.h"
+#include "spin_mutex.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace is::signals
+{
+
+/// Thread pool with work stealing: each worker has its own task queue, idle workers steal tasks from other queues.
+/// Used for parallel emission of signals, see signal::set_parallel_emission().
+class thread_pool
+{
+public:
+	/// Starts given number of worker threads, at least one.
+	explicit thread_pool(std::size_t threadCount = std::thread::hardware_concurrency());
+
+	/// Runs all posted tasks and stops worker threads.
+	~thread_pool();
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	/**
+	 * size() method returns number of worker threads
+	 */
+	[[nodiscard]] std::size_t size() const noexcept;
+
+	/**
+	 * post(task) method schedules task on worker thread.
+	 * Task should not throw exceptions.
+	 */
+	void post(function<void()> task);
+
+	/**
+	 * parallel_for(count, grainSize, body) method splits range [0, count) into chunks of grainSize items
+	 *  and calls body(begin, end) for each chunk on worker threads and calling thread.
+	 * Returns when all chunks processed, rethrows first exception thrown by body.
+	 * If chunk cannot be queued, it's processed on calling thread and the exception is rethrown after all chunks processed.
+	 * Calling thread runs other queued tasks while waiting, so parallel_for can be nested.
+	 */
+	void parallel_for(std::size_t count, std::size_t grainSize, const function<void(std::size_t, std::size_t)>& body);
+
+private:
+	struct LIBFASTSIGNALS_CACHE_LINE_ALIGN worker
+	{
+		detail::spin_mutex mutex;
+		std::deque<function<void()>> tasks;
+		std::thread thread;
+	};
+
+	void stop() noexcept;
+	void run_worker(std::size_t index);
+	bool try_run_task(std::size_t index);
+	std::size_t get_queue_index() noexcept;
+
+	std::vector<std::unique_ptr<worker>> m_workers;
+	std::atomic<std::size_t> m_nextQueue = 0;
+	std::atomic<std::size_t> m_taskCount = 0;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeup;
+	bool m_stopped = false;
+};
+
+} // namespace is::signals
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "combiners.h"
+#include "connection.h"
+#include "function_detail.h"
+#include "slot_states.h"
+#include "span.h"
+#include "spin_mutex.h"
+#include "type_traits.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER)
+#	include "msvc_autolink.h"
+#endif
+
+namespace is::signals
+{
+namespace detail
+{
+
+template <class Signature, class Callable>
+class typed_signal_impl;
+
+/// Keeps slots of one callable type in contiguous storage without type erasure, sorted by id as signal_impl does.
+/// Emission copies a few slots with one lock and calls them directly, so compiler can inline the call.
+/// Slot disconnected after it was copied is skipped, since emission checks its state before the call.
+template <class Callable, class Return, class... Arguments>
+class typed_signal_impl<Return(Arguments...), Callable> final : public slot_owner
+{
+public:
+	// Removed slot is moved into packed_function which slot states destroy after unlocking, so it must not throw.
+	static_assert(is_noexcept_packed_function_init<Callable, Return, Arguments...>,
+		"typed signal callable must fit function buffer and be nothrow move constructible");
+	static_assert(std::is_nothrow_move_assignable_v<Callable>, "typed signal callable must be nothrow move assignable");
+	static_assert(std::is_copy_constructible_v<Callable>, "typed signal callable must be copy constructible");
+
+	typed_signal_impl()
+		: m_states(std::make_shared<slot_states>(*this))
+	{
+	}
+
+	typed_signal_impl(const typed_signal_impl&) = delete;
+	typed_signal_impl& operator=(const typed_signal_impl&) = delete;
+
+	// Invalidates connections of this signal.
+	~typed_signal_impl()
+	{
+		m_states->detach();
+	}
+
+	slot_key add(Callable callable)
+	{
+		// Old storage is destroyed after mutex unlocked.
+		std::vector<Callable> releasedCallables;
+		std::vector<slot_key> releasedKeys;
+		slot_states::chunk_ptr spareChunk;
+		std::unique_lock lock(m_mutex);
+		m_states->reserve_entry(lock, spareChunk);
+
+		// As in signal_impl, storage is allocated while mutex unlocked.
+		while (m_keys.size() >= std::min(m_callables.capacity(), m_keys.capacity()))
+		{
+			const size_t capacity = std::max(m_keys.size() * 2, size_t(4));
+			lock.unlock();
+			std::vector<Callable> callables;
+			std::vector<slot_key> keys;
+			callables.reserve(capacity);
+			keys.reserve(capacity);
+			lock.lock();
+			if (m_keys.size() < capacity)
+			{
+				std::move(m_callables.begin(), m_callables.end(), std::back_inserter(callables));
+				keys.assign(m_keys.begin(), m_keys.end());
+				m_callables.swap(callables);
+				m_keys.swap(keys);
+				releasedCallables.swap(callables);
+				releasedKeys.swap(keys);
+			}
+			// Other thread could take free entry while mutex was unlocked.
+			m_states->reserve_entry(lock, spareChunk);
+		}
+
+		const uint64_t id = m_nextId++;
+		const slot_key key = { id, m_states->acquire(id) };
+		m_callables.push_back(std::move(callable));
+		m_keys.push_back(key);
+		return key;
+	}
+
+	void remove(slot_key key, packed_function& removedFunction, released_storage_ptr& /*releasedStorage*/) noexcept final
+	{
+		std::lock_guard lock(m_mutex);
+		auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key.id, [](const slot_key& key, uint64_t id) {
+			return key.id < id;
+		});
+		if (it != m_keys.end() && it->id == key.id)
+		{
+			const size_t i = std::distance(m_keys.begin(), it);
+			removedFunction.init<Callable, Return, Arguments...>(std::move(m_callables[i]));
+			m_states->release(key);
+			m_keys.erase(it);
+			m_callables.erase(m_callables.begin() + i);
+		}
+	}
+
+	void remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& /*releasedStorage*/) noexcept final
+	{
+		std::lock_guard lock(m_mutex);
+		// Both key sequences are sorted by id, so slots are compacted in one pass.
+		const slot_key* removedKey = keys.begin();
+		size_t kept = 0;
+		for (size_t i = 0; i < m_keys.size(); ++i)
+		{
+			while (removedKey != keys.end() && removedKey->id < m_keys[i].id)
+			{
+				++removedKey;
+			}
+			if (removedKey != keys.end() && removedKey->id == m_keys[i].id)
+			{
+				removedFunctions.emplace_back().init<Callable, Return, Arguments...>(std::move(m_callables[i]));
+				m_states->release(m_keys[i]);
+				++removedKey;
+				continue;
+			}
+			if (kept != i)
+			{
+				m_keys[kept] = m_keys[i];
+				m_callables[kept] = std::move(m_callables[i]);
+			}
+			++kept;
+		}
+		m_keys.erase(m_keys.begin() + kept, m_keys.end());
+		m_callables.erase(m_callables.begin() + kept, m_callables.end());
+	}
+
+	void remove_all() noexcept
+	{
+		std::vector<Callable> callables;
+		std::vector<slot_key> keys;
+		{
+			std::lock_guard lock(m_mutex);
+			callables.swap(m_callables);
+			keys.swap(m_keys);
+			m_states->release_all();
+		}
+	}
+
+	size_t count() const noexcept
+	{
+		std::lock_guard lock(m_mutex);
+		return m_keys.size();
+	}
+
+	const slot_states_ptr& states() const noexcept
+	{
+		return m_states;
+	}
+
+	template <class Combiner, class Result, class... Args>
+	Result invoke(Args... args)
+	{
+		slot_batch batch;
+		slot_cursor cursor;
+		if constexpr (std::is_same_v<Result, void>)
+		{
+			while (get_next_slots(batch, cursor))
+			{
+				for (size_t i = 0; i < batch.size; ++i)
+				{
+					if (m_states->is_connected(batch.keys[i]))
+					{
+						(*batch.callables[i])(std::forward<Args>(args)...);
+					}
+				}
+			}
+		}
+		else
+		{
+			Combiner combiner;
+			while (get_next_slots(batch, cursor))
+			{
+				for (size_t i = 0; i < batch.size; ++i)
+				{
+					if (m_states->is_connected(batch.keys[i]))
+					{
+						combiner((*batch.callables[i])(std::forward<Args>(args)...));
+					}
+				}
+			}
+			return combiner.get_value();
+		}
+	}
+
+private:
+	static constexpr size_t batch_capacity = 16;
+
+	// Copies of slots which emission calls without lock.
+	struct slot_batch
+	{
+		std::array<std::optional<Callable>, batch_capacity> callables;
+		std::array<slot_key, batch_capacity> keys;
+		size_t size = 0;
+	};
+
+	struct slot_cursor
+	{
+		size_t index = 0;
+		uint64_t nextId = 1;
+		uint64_t endId = 0;
+	};
+
+	bool get_next_slots(slot_batch& batch, slot_cursor& cursor)
+	{
+		// Previous slots are destroyed before mutex locked.
+		for (size_t i = 0; i < batch.size; ++i)
+		{
+			batch.callables[i].reset();
+		}
+		batch.size = 0;
+		std::lock_guard lock(m_mutex);
+
+		// Slots connected during emission are called by the next emission.
+		if (cursor.endId == 0)
+		{
+			cursor.endId = m_nextId;
+		}
+		if (cursor.nextId >= cursor.endId)
+		{
+			return false;
+		}
+		// Avoid binary search if next slot wasn't moved between mutex locks.
+		if (cursor.index >= m_keys.size() || m_keys[cursor.index].id != cursor.nextId)
+		{
+			cursor.index = std::distance(m_keys.begin(), std::lower_bound(m_keys.begin(), m_keys.end(), cursor.nextId, [](const slot_key& key, uint64_t id) {
+				return key.id < id;
+			}));
+		}
+		while (batch.size < batch_capacity && cursor.index < m_keys.size() && m_keys[cursor.index].id < cursor.endId)
+		{
+			batch.callables[batch.size].emplace(m_callables[cursor.index]);
+			batch.keys[batch.size] = m_keys[cursor.index];
+			++batch.size;
+			++cursor.index;
+		}
+		// Any slot connected later will have id not less than m_nextId.
+		cursor.nextId = (cursor.index < m_keys.size()) ? m_keys[cursor.index].id : m_nextId;
+		return batch.size != 0;
+	}
+
+	mutable spin_mutex m_mutex;
+	std::vector<Callable> m_callables;
+	std::vector<slot_key> m_keys;
+	uint64_t m_nextId = 1;
+	slot_states_ptr m_states;
+};
+
+} // namespace detail
+
+template <class Signature, class Callable, template <class T> class Combiner = optional_last_value>
+class typed_signal;
+
+/// Typed signal has the same API as signal, but all its slots have the same Callable type,
+///  such as function pointer or functor which keeps object pointer, and are stored without type erasure.
+/// Slot takes sizeof(Callable) bytes instead of packed_function and emission calls it directly,
+///  so compiler can inline the call. Slots are called in connection order and return the same connection,
+///  so subscribers work with typed signal as with ordinary signal.
+/// Callable must be copyable, nothrow movable and nothrow move assignable, and fit function buffer.
+///  Lambdas aren't assignable, so use signal for them.
+template <class Return, class... Arguments, class Callable, template <class T> class Combiner>
+class typed_signal<Return(Arguments...), Callable, Combiner>
+{
+public:
+	using signature_type = Return(signal_arg_t<Arguments>...);
+	using slot_type = Callable;
+	using combiner_type = Combiner<Return>;
+	using result_type = typename combiner_type::result_type;
+
+	typed_signal()
+		: m_impl(std::make_shared<impl_type>())
+	{
+	}
+
+	/// No copy construction
+	typed_signal(const typed_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	typed_signal(typed_signal&& other) = default;
+
+	/// No copy assignment
+	typed_signal& operator=(const typed_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	typed_signal& operator=(typed_signal&& other) = default;
+
+	/**
+	 * connect(slot) method subscribes slot to signal emission event.
+	 * Each time you call signal as functor, all slots are also called with given arguments.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(slot_type slot)
+	{
+		const auto key = m_impl->add(std::move(slot));
+		return connection(m_impl->states(), key);
+	}
+
+	/**
+	 * disconnect_all_slots() method disconnects all slots from signal emission event.
+	 */
+	void disconnect_all_slots() noexcept
+	{
+		m_impl->remove_all();
+	}
+
+	/**
+	 * num_slots() method returns number of slots attached to this singal
+	 */
+	[[nodiscard]] std::size_t num_slots() const noexcept
+	{
+		return m_impl->count();
+	}
+
+	/**
+	 * empty() method returns true if signal has any slots attached
+	 */
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return m_impl->count() == 0;
+	}
+
+	/**
+	 * operator(args...) calls all slots connected to this signal.
+	 * Logically, it fires signal emission event.
+	 */
+	result_type operator()(signal_arg_t<Arguments>... args) const
+	{
+		return impl_ptr(m_impl)->template invoke<combiner_type, result_type, signal_arg_t<Arguments>...>(args...);
+	}
+
+	void swap(typed_signal& other) noexcept
+	{
+		m_impl.swap(other.m_impl);
+	}
+
+private:
+	using impl_type = detail::typed_signal_impl<signature_type, Callable>;
+	using impl_ptr = std::shared_ptr<impl_type>;
+
+	impl_ptr m_impl;
+};
+
+} // namespace is::signals
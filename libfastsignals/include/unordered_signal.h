@@ -0,0 +1,118 @@
+#pragma once
+
+#include "combiners.h"
+#include "connection.h"
+#include "function.h"
+#include "type_traits.h"
+#include "unordered_signal_impl.h"
+#include <cstddef>
+#include <memory>
+
+#if defined(_MSC_VER)
+#	include "msvc_autolink.h"
+#endif
+
+namespace is::signals
+{
+template <class Signature, template <class T> class Combiner = optional_last_value>
+class unordered_signal;
+
+/// Unordered signal has the same API as signal, but calls slots in unspecified order.
+/// Disconnect takes constant time: slot is found by its connection and swapped with the last slot.
+/// Slots are grouped by type of callable, so emission calls slots of the same type one after another.
+/// Concurrent emission never calls slot disconnected before emission reached it,
+///  and may or may not call slot connected after emission started.
+/// Use it for fan-out signals with many slots which don't depend on call order, such as cache invalidation.
+template <class Return, class... Arguments, template <class T> class Combiner>
+class unordered_signal<Return(Arguments...), Combiner> : private not_directly_callable
+{
+public:
+	using signature_type = Return(signal_arg_t<Arguments>...);
+	using slot_type = function<signature_type>;
+	using combiner_type = Combiner<Return>;
+	using result_type = typename combiner_type::result_type;
+
+	unordered_signal()
+		: m_impl(std::make_shared<detail::unordered_signal_impl>())
+	{
+	}
+
+	/// No copy construction
+	unordered_signal(const unordered_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	unordered_signal(unordered_signal&& other) = default;
+
+	/// No copy assignment
+	unordered_signal& operator=(const unordered_signal&) = delete;
+
+	/// Moves signal from other. Any operations on other except destruction, move, and swap are invalid
+	unordered_signal& operator=(unordered_signal&& other) = default;
+
+	/**
+	 * connect(slot) method subscribes slot to signal emission event.
+	 * Each time you call signal as functor, all slots are also called with given arguments.
+	 * @returns connection - object which manages signal-slot connection lifetime
+	 */
+	connection connect(slot_type slot)
+	{
+		const auto key = m_impl->add(slot.release());
+		return connection(m_impl->states(), key);
+	}
+
+	/**
+	 * disconnect_all_slots() method disconnects all slots from signal emission event.
+	 */
+	void disconnect_all_slots() noexcept
+	{
+		m_impl->remove_all();
+	}
+
+	/**
+	 * num_slots() method returns number of slots attached to this singal
+	 */
+	[[nodiscard]] std::size_t num_slots() const noexcept
+	{
+		return m_impl->count();
+	}
+
+	/**
+	 * empty() method returns true if signal has any slots attached
+	 */
+	[[nodiscard]] bool empty() const noexcept
+	{
+		return m_impl->count() == 0;
+	}
+
+	/**
+	 * operator(args...) calls all slots connected to this signal in unspecified order.
+	 * Logically, it fires signal emission event.
+	 */
+	result_type operator()(signal_arg_t<Arguments>... args) const
+	{
+		return detail::unordered_signal_impl_ptr(m_impl)->invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+	}
+
+	void swap(unordered_signal& other) noexcept
+	{
+		m_impl.swap(other.m_impl);
+	}
+
+	/**
+	 * Allows using signals as slots for another signal
+	 */
+	operator slot_type() const noexcept
+	{
+		return [weakImpl = std::weak_ptr<detail::unordered_signal_impl>(m_impl)](signal_arg_t<Arguments>... args) {
+			if (auto impl = weakImpl.lock())
+			{
+				return impl->invoke<combiner_type, result_type, signature_type, signal_arg_t<Arguments>...>(args...);
+			}
+		};
+	}
+
+private:
+	detail::unordered_signal_impl_ptr m_impl;
+};
+
+} // namespace is::signals
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "function_detail.h"
+#include "slot_states.h"
+#include "span.h"
+#include "spin_mutex.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace is::signals::detail
+{
+
+/// Keeps slots in buckets by type of callable, slots of one bucket are called one after another,
+///  so indirect call of each slot has the same target as the previous one.
+/// Slot is found by index of its connection state and removed by swapping with the last slot of bucket.
+/// While emission runs, removed slots leave empty places which are compacted after the last emission.
+class unordered_signal_impl final : public slot_owner
+{
+public:
+	unordered_signal_impl();
+	unordered_signal_impl(const unordered_signal_impl&) = delete;
+	unordered_signal_impl& operator=(const unordered_signal_impl&) = delete;
+
+	// Invalidates connections of this signal.
+	~unordered_signal_impl();
+
+	slot_key add(packed_function fn);
+
+	// Called by slot states: removed slots are moved into given storage, so caller destroys them after unlocking states.
+	void remove(slot_key key, packed_function& removedFunction, released_storage_ptr& releasedStorage) noexcept final;
+	void remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& releasedStorage) noexcept final;
+
+	void remove_all() noexcept;
+
+	size_t count() const noexcept;
+
+	const slot_states_ptr& states() const noexcept;
+
+	template <class Combiner, class Result, class Signature, class... Args>
+	Result invoke(Args... args)
+	{
+		emission_guard guard(*this);
+		packed_function slot;
+		slot_cursor cursor;
+		if constexpr (std::is_same_v<Result, void>)
+		{
+			while (get_next_slot(slot, cursor))
+			{
+				slot.call<Signature>(std::forward<Args>(args)...);
+			}
+		}
+		else
+		{
+			Combiner combiner;
+			while (get_next_slot(slot, cursor))
+			{
+				combiner(slot.call<Signature>(std::forward<Args>(args)...));
+			}
+			return combiner.get_value();
+		}
+	}
+
+private:
+	// Slots with the same type of callable.
+	struct slot_bucket
+	{
+		const void* typeKey = nullptr;
+		std::vector<packed_function> functions;
+		// Index of connection state for each slot, or removed_state_index for empty place.
+		std::vector<uint32_t> stateIndexes;
+	};
+
+	struct slot_position
+	{
+		uint32_t bucket = 0;
+		uint32_t index = 0;
+	};
+
+	struct slot_cursor
+	{
+		size_t bucket = 0;
+		size_t index = 0;
+	};
+
+	// Counts running emissions, slots aren't moved while any emission runs.
+	class emission_guard
+	{
+	public:
+		explicit emission_guard(unordered_signal_impl& impl) noexcept;
+		emission_guard(const emission_guard&) = delete;
+		emission_guard& operator=(const emission_guard&) = delete;
+		~emission_guard();
+
+	private:
+		unordered_signal_impl& m_impl;
+	};
+
+	static constexpr uint32_t removed_state_index = UINT32_MAX;
+
+	bool get_next_slot(packed_function& slot, slot_cursor& cursor);
+	void remove_locked(slot_key key, packed_function& removedFunction) noexcept;
+	void erase_locked(slot_position position) noexcept;
+	// Erases empty places left by slots removed during emission.
+	void compact_locked() noexcept;
+
+	mutable spin_mutex m_mutex;
+	std::vector<slot_bucket> m_buckets;
+	// Position of slot for each entry of connection states.
+	std::vector<slot_position> m_positions;
+	size_t m_count = 0;
+	size_t m_emissionCount = 0;
+	size_t m_removedCount = 0;
+	uint64_t m_nextId = 1;
+	slot_states_ptr m_states;
+};
+
+using unordered_signal_impl_ptr = std::shared_ptr<unordered_signal_impl>;
+
+} // namespace is::signals::detail
@@ -21,16 +21,15 @@ auto get_advanced_connection_impl(const advanced_connection& connection) noexcep
 } // namespace
 
 connection::connection(connection&& other) noexcept
-	: m_storage(other.m_storage)
-	, m_id(other.m_id)
+	: m_states(std::move(other.m_states))
+	, m_key(other.m_key)
 {
-	other.m_storage.reset();
-	other.m_id = 0;
+	other.m_key = {};
 }
 
-connection::connection(detail::signal_impl_weak_ptr storage, uint64_t id) noexcept
-	: m_storage(std::move(storage))
-	, m_id(id)
+connection::connection(detail::slot_states_ptr states, detail::slot_key key) noexcept
+	: m_states(std::move(states))
+	, m_key(key)
 {
 }
 
@@ -40,10 +39,9 @@ connection::connection(const connection& other) noexcept = default;
 
 connection& connection::operator=(connection&& other) noexcept
 {
-	m_storage = other.m_storage;
-	m_id = other.m_id;
-	other.m_storage.reset();
-	other.m_id = 0;
+	m_states = std::move(other.m_states);
+	m_key = other.m_key;
+	other.m_key = {};
 	return *this;
 }
 
@@ -51,17 +49,21 @@ connection& connection::operator=(const connection& other) noexcept = default;
 
 bool connection::connected() const noexcept
 {
-	return (m_id != 0);
+	return m_states && m_states->is_connected(m_key);
 }
 
 void connection::disconnect() noexcept
 {
-	if (auto storage = m_storage.lock())
+	if (m_states)
 	{
-		storage->remove(m_id);
-		m_storage.reset();
+		// Slot is removed only if it's still connected, so disconnected slot doesn't take locks.
+		if (m_states->is_connected(m_key))
+		{
+			m_states->disconnect(m_key);
+		}
+		m_states.reset();
 	}
-	m_id = 0;
+	m_key = {};
 }
 
 scoped_connection::scoped_connection(connection&& conn) noexcept
@@ -127,6 +129,32 @@ advanced_connection& advanced_connection::operator=(const advanced_connection&)
 
 advanced_connection& advanced_connection::operator=(advanced_connection&& other) noexcept = default;
 
+queued_connection::queued_connection() noexcept = default;
+
+queued_connection::queued_connection(connection&& conn, impl_ptr&& impl) noexcept
+	: connection(std::move(conn))
+	, m_impl(std::move(impl))
+{
+}
+
+queued_connection::queued_connection(const queued_connection&) noexcept = default;
+
+queued_connection::queued_connection(queued_connection&& other) noexcept = default;
+
+queued_connection& queued_connection::operator=(const queued_connection&) noexcept = default;
+
+queued_connection& queued_connection::operator=(queued_connection&& other) noexcept = default;
+
+uint64_t queued_connection::dropped_count() const noexcept
+{
+	return m_impl ? m_impl->droppedCount.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t queued_connection::coalesced_count() const noexcept
+{
+	return m_impl ? m_impl->coalescedCount.load(std::memory_order_relaxed) : 0;
+}
+
 shared_connection_block::shared_connection_block(const advanced_connection& connection, bool initially_blocked) noexcept
 	: m_connection(get_advanced_connection_impl(connection))
 {
@@ -0,0 +1,100 @@
+#include "../include/connection_group.h"
+#include <algorithm>
+#include <functional>
+#include <new>
+
+namespace is::signals
+{
+
+connection_group::connection_group() noexcept = default;
+
+connection_group::connection_group(connection_group&& other) noexcept = default;
+
+connection_group& connection_group::operator=(connection_group&& other) noexcept
+{
+	if (&other != this)
+	{
+		disconnect();
+		m_entries = std::move(other.m_entries);
+		other.m_entries.clear();
+	}
+	return *this;
+}
+
+connection_group::~connection_group()
+{
+	disconnect();
+}
+
+void connection_group::add(connection conn)
+{
+	if (!conn.m_states)
+	{
+		return;
+	}
+	m_entries.push_back({ std::move(conn.m_states), conn.m_key });
+	conn.m_key = {};
+}
+
+void connection_group::disconnect() noexcept
+{
+	std::vector<entry> entries;
+	entries.swap(m_entries);
+
+	// Entries of one signal become adjacent and sorted by slot id.
+	std::sort(entries.begin(), entries.end(), [](const entry& lhs, const entry& rhs) {
+		if (lhs.states != rhs.states)
+		{
+			return std::less<>()(lhs.states.get(), rhs.states.get());
+		}
+		return lhs.key.id < rhs.key.id;
+	});
+
+	// Keys of all signals reuse the same buffer, if it cannot be allocated slots are removed one by one.
+	std::vector<detail::slot_key> keys;
+	try
+	{
+		keys.reserve(entries.size());
+	}
+	catch (const std::bad_alloc& /*e*/)
+	{
+		for (auto& item : entries)
+		{
+			connection(std::move(item.states), item.key).disconnect();
+		}
+		return;
+	}
+
+	for (auto first = entries.begin(); first != entries.end();)
+	{
+		auto last = std::find_if(first + 1, entries.end(), [first](const entry& item) {
+			return item.states != first->states;
+		});
+		// Slots which are already disconnected don't need signal lock.
+		keys.clear();
+		for (auto it = first; it != last; ++it)
+		{
+			if (it->states->is_connected(it->key))
+			{
+				keys.push_back(it->key);
+			}
+		}
+		if (!keys.empty())
+		{
+			first->states->disconnect(span<const detail::slot_key>(keys));
+		}
+		first = last;
+	}
+}
+
+size_t connection_group::size() const noexcept
+{
+	return m_entries.size();
+}
+
+bool connection_group::empty() const noexcept
+{
+	return m_entries.empty();
+}
+
+} // namespace is::signals
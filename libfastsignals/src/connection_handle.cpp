@@ -0,0 +1,22 @@
+#include "../include/connection_handle.h"
+
+namespace is::signals
+{
+
+connection_handle::connection_handle(detail::connection_handle_data data) noexcept
+	: m_data(data)
+{
+}
+
+bool connection_handle::connected() const noexcept
+{
+	return detail::connection_table::instance().connected(m_data);
+}
+
+void connection_handle::disconnect() noexcept
+{
+	detail::connection_table::instance().disconnect(m_data);
+	m_data = {};
+}
+
+} // namespace is::signals
@@ -0,0 +1,234 @@
+#include "../include/connection_table.h"
+#include "../include/signal_impl.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+
+namespace is::signals::detail
+{
+namespace
+{
+std::uint32_t next_generation(std::uint32_t generation) noexcept
+{
+	// Zero generation is never used, so default handle never matches any entry.
+	return (generation == std::numeric_limits<std::uint32_t>::max()) ? 1 : generation + 1;
+}
+} // namespace
+
+connection_table& connection_table::instance() noexcept
+{
+	// Table is never destroyed, so signals can be destroyed after other static objects.
+	static connection_table* table = new connection_table();
+	return *table;
+}
+
+std::uint32_t connection_table::shard_index(const signal_impl* signal) noexcept
+{
+	// Low bits of address are the same for aligned allocations, so they are skipped.
+	const auto address = reinterpret_cast<std::uintptr_t>(signal);
+	return static_cast<std::uint32_t>((address >> 4) ^ (address >> 12)) & (shard_count - 1);
+}
+
+std::uint32_t connection_table::shard_index(connection_handle_data handle) noexcept
+{
+	return handle.index & (shard_count - 1);
+}
+
+connection_handle_data connection_table::acquire(signal_impl* signal)
+{
+	const std::uint32_t shardIndex = shard_index(signal);
+	shard& owner = m_shards[shardIndex];
+	std::lock_guard lock(owner.mutex);
+	return acquire_locked(owner, shardIndex, signal);
+}
+
+void connection_table::acquire(signal_impl* signal, std::size_t count, std::vector<connection_handle_data>& handles)
+{
+	const std::size_t firstHandle = handles.size();
+	handles.reserve(firstHandle + count);
+
+	const std::uint32_t shardIndex = shard_index(signal);
+	shard& owner = m_shards[shardIndex];
+	std::lock_guard lock(owner.mutex);
+	try
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			handles.push_back(acquire_locked(owner, shardIndex, signal));
+		}
+	}
+	catch (...)
+	{
+		for (std::size_t i = firstHandle; i < handles.size(); ++i)
+		{
+			release_locked(owner, handles[i]);
+		}
+		handles.resize(firstHandle);
+		throw;
+	}
+}
+
+connection_handle_data connection_table::acquire_locked(shard& owner, std::uint32_t shardIndex, signal_impl* signal)
+{
+	std::uint32_t localIndex = owner.freeHead;
+	if (localIndex == 0)
+	{
+		if (owner.entries.size() == (std::numeric_limits<std::uint32_t>::max() >> shard_bits))
+		{
+			throw std::bad_alloc();
+		}
+		owner.entries.emplace_back().generation = owner.firstGeneration;
+		localIndex = static_cast<std::uint32_t>(owner.entries.size());
+	}
+	entry& item = owner.entries[localIndex - 1];
+	owner.freeHead = item.nextFree;
+	++owner.usedCount;
+	item.nextFree = 0;
+	item.signal = signal;
+	item.slotId = 0;
+	return { (localIndex << shard_bits) | shardIndex, item.generation };
+}
+
+void connection_table::set_slot_id(connection_handle_data handle, std::uint64_t slotId) noexcept
+{
+	shard& owner = m_shards[shard_index(handle)];
+	std::lock_guard lock(owner.mutex);
+	if (is_valid_locked(owner, handle))
+	{
+		owner.entries[(handle.index >> shard_bits) - 1].slotId = slotId;
+	}
+}
+
+void connection_table::set_slot_ids(span<const connection_handle_data> handles, std::uint64_t firstSlotId) noexcept
+{
+	if (handles.empty())
+	{
+		return;
+	}
+
+	// Handles are taken by one signal, so they belong to the same shard.
+	shard& owner = m_shards[shard_index(*handles.begin())];
+	std::lock_guard lock(owner.mutex);
+	std::uint64_t slotId = firstSlotId;
+	for (const auto& handle : handles)
+	{
+		if (is_valid_locked(owner, handle))
+		{
+			owner.entries[(handle.index >> shard_bits) - 1].slotId = slotId;
+		}
+		++slotId;
+	}
+}
+
+void connection_table::release(connection_handle_data handle) noexcept
+{
+	shard& owner = m_shards[shard_index(handle)];
+	std::lock_guard lock(owner.mutex);
+	release_locked(owner, handle);
+}
+
+void connection_table::release(span<const connection_handle_data> handles) noexcept
+{
+	if (handles.empty())
+	{
+		return;
+	}
+
+	// Handles are taken by one signal, so they belong to the same shard.
+	shard& owner = m_shards[shard_index(*handles.begin())];
+	std::lock_guard lock(owner.mutex);
+	for (const auto& handle : handles)
+	{
+		release_locked(owner, handle);
+	}
+}
+
+void connection_table::release(const std::vector<connection_table_ref>& refs) noexcept
+{
+	if (refs.empty())
+	{
+		return;
+	}
+
+	// Refs are kept by one signal, so their handles belong to the same shard.
+	shard& owner = m_shards[shard_index(refs.front().handle)];
+	std::lock_guard lock(owner.mutex);
+	for (const auto& ref : refs)
+	{
+		release_locked(owner, ref.handle);
+	}
+}
+
+bool connection_table::connected(connection_handle_data handle) const noexcept
+{
+	const shard& owner = m_shards[shard_index(handle)];
+	std::lock_guard lock(owner.mutex);
+	return is_valid_locked(owner, handle);
+}
+
+void connection_table::disconnect(connection_handle_data handle) noexcept
+{
+	// Slot destroyed after signal unlocked, so its destructor can use connection handles.
+	packed_function removedFunction;
+	signal_impl* signal = nullptr;
+	std::uint64_t slotId = 0;
+	{
+		shard& owner = m_shards[shard_index(handle)];
+		std::lock_guard lock(owner.mutex);
+		if (!is_valid_locked(owner, handle))
+		{
+			return;
+		}
+		const entry& item = owner.entries[(handle.index >> shard_bits) - 1];
+		signal = item.signal;
+		slotId = item.slotId;
+		// Signal releases its entries before it's destroyed, so it's alive while entry is valid.
+		signal->begin_remove_with_handle();
+		release_locked(owner, handle);
+	}
+	signal->remove_with_handle(slotId, removedFunction);
+}
+
+bool connection_table::is_valid_locked(const shard& owner, connection_handle_data handle) noexcept
+{
+	const std::uint32_t localIndex = handle.index >> shard_bits;
+	if (localIndex == 0 || localIndex > owner.entries.size())
+	{
+		return false;
+	}
+	const entry& item = owner.entries[localIndex - 1];
+	return item.generation == handle.generation && item.signal != nullptr;
+}
+
+void connection_table::release_locked(shard& owner, connection_handle_data handle) noexcept
+{
+	if (!is_valid_locked(owner, handle))
+	{
+		return;
+	}
+	const std::uint32_t localIndex = handle.index >> shard_bits;
+	entry& item = owner.entries[localIndex - 1];
+	item.signal = nullptr;
+	item.slotId = 0;
+	item.generation = next_generation(item.generation);
+	item.nextFree = owner.freeHead;
+	owner.freeHead = localIndex;
+
+	if (--owner.usedCount == 0 && owner.entries.size() > retained_entries)
+	{
+		// Large shard releases its memory when its last entry is free, new entries start with
+		//  generation greater than any removed entry had, so stale handles still don't match.
+		std::uint32_t maxGeneration = owner.firstGeneration;
+		for (const entry& removed : owner.entries)
+		{
+			maxGeneration = std::max(maxGeneration, removed.generation);
+		}
+		std::deque<entry>().swap(owner.entries);
+		owner.freeHead = 0;
+		owner.firstGeneration = maxGeneration;
+	}
+}
+
+} // namespace is::signals::detail
@@ -0,0 +1,67 @@
+#include "../include/deferred_emission.h"
+#include <exception>
+
+namespace is::signals
+{
+namespace
+{
+// The innermost scope of current thread.
+thread_local deferred_emission_scope* t_currentScope = nullptr;
+} // namespace
+
+namespace detail
+{
+
+deferred_signal_base* find_deferred_signal(const signal_impl* signal) noexcept
+{
+	for (const auto* scope = t_currentScope; scope != nullptr; scope = scope->m_parent)
+	{
+		if (auto* deferred = scope->find_own(signal))
+		{
+			return deferred;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace detail
+
+deferred_emission_scope::deferred_emission_scope() noexcept
+	: m_parent(t_currentScope)
+	, m_uncaughtExceptions(std::uncaught_exceptions())
+{
+	t_currentScope = this;
+}
+
+deferred_emission_scope::~deferred_emission_scope() noexcept(false)
+{
+	// Delivered emissions are recorded by outer scopes, not by this one.
+	t_currentScope = m_parent;
+	for (auto& [signal, deferred] : m_signals)
+	{
+		deferred->release();
+	}
+
+	if (std::uncaught_exceptions() > m_uncaughtExceptions)
+	{
+		return;
+	}
+	for (auto& [signal, deferred] : m_signals)
+	{
+		deferred->deliver();
+	}
+}
+
+detail::deferred_signal_base* deferred_emission_scope::find_own(const detail::signal_impl* signal) const noexcept
+{
+	for (const auto& [deferredSignal, deferred] : m_signals)
+	{
+		if (deferredSignal == signal && !deferred->expired())
+		{
+			return deferred.get();
+		}
+	}
+	return nullptr;
+}
+
+} // namespace is::signals
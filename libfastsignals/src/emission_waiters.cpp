@@ -0,0 +1,118 @@
+#include "../include/emission_waiters.h"
+#include <climits>
+
+#if defined(__linux__)
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <time.h>
+#	include <unistd.h>
+#endif
+
+namespace is::signals::detail
+{
+
+#if defined(__linux__)
+
+namespace
+{
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word should be plain 32-bit integer");
+
+void futex_wait(const std::atomic<std::uint32_t>& word, std::uint32_t expected, const timespec* timeout) noexcept
+{
+	// Returns immediately if word already changed; timeout, EINTR and spurious wakeups are handled by caller.
+	::syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+}
+
+void futex_wake_all(const std::atomic<std::uint32_t>& word) noexcept
+{
+	::syscall(SYS_futex, reinterpret_cast<const std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+} // namespace
+
+void emission_waiters::notify_slow() const noexcept
+{
+	m_emissionCount.fetch_add(1, std::memory_order_release);
+	futex_wake_all(m_emissionCount);
+}
+
+bool emission_waiters::wait_impl(const std::chrono::steady_clock::time_point* deadline) const
+{
+	m_waiterCount.fetch_add(1);
+	const std::uint32_t emissionCount = m_emissionCount.load();
+
+	bool emitted = false;
+	while (true)
+	{
+		if (m_emissionCount.load(std::memory_order_acquire) != emissionCount)
+		{
+			emitted = true;
+			break;
+		}
+		if (deadline == nullptr)
+		{
+			futex_wait(m_emissionCount, emissionCount, nullptr);
+			continue;
+		}
+
+		const auto remaining = *deadline - std::chrono::steady_clock::now();
+		if (remaining <= std::chrono::steady_clock::duration::zero())
+		{
+			break;
+		}
+		const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+		const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - seconds);
+		const timespec timeout = { static_cast<time_t>(seconds.count()), static_cast<long>(nanoseconds.count()) };
+		futex_wait(m_emissionCount, emissionCount, &timeout);
+	}
+
+	m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	return emitted;
+}
+
+#else
+
+void emission_waiters::notify_slow() const noexcept
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_emissionCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	m_emitted.notify_all();
+}
+
+bool emission_waiters::wait_impl(const std::chrono::steady_clock::time_point* deadline) const
+{
+	std::unique_lock lock(m_mutex);
+	m_waiterCount.fetch_add(1);
+	const std::uint32_t emissionCount = m_emissionCount.load(std::memory_order_relaxed);
+	auto isEmitted = [&] {
+		return m_emissionCount.load(std::memory_order_relaxed) != emissionCount;
+	};
+
+	bool emitted = true;
+	if (deadline == nullptr)
+	{
+		m_emitted.wait(lock, isEmitted);
+	}
+	else
+	{
+		emitted = m_emitted.wait_until(lock, *deadline, isEmitted);
+	}
+
+	m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	return emitted;
+}
+
+#endif
+
+bool emission_waiters::wait_until(std::chrono::steady_clock::time_point deadline) const
+{
+	return wait_impl(&deadline);
+}
+
+void emission_waiters::wait() const
+{
+	wait_impl(nullptr);
+}
+
+} // namespace is::signals::detail
@@ -0,0 +1,188 @@
+#include "../include/event_loop.h"
+#include <cerrno>
+#include <cstdint>
+#include <system_error>
+
+#if defined(__linux__)
+#	include <poll.h>
+#	include <sys/eventfd.h>
+#	include <unistd.h>
+#endif
+
+namespace is::signals
+{
+
+#if defined(__linux__)
+
+event_loop::event_loop()
+	: m_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+	if (m_fd == -1)
+	{
+		throw std::system_error(errno, std::generic_category(), "cannot create eventfd");
+	}
+}
+
+event_loop::~event_loop()
+{
+	::close(m_fd);
+}
+
+int event_loop::fd() const noexcept
+{
+	return m_fd;
+}
+
+void event_loop::wakeup() noexcept
+{
+	const std::uint64_t value = 1;
+	// Write can fail only if counter overflows, then event loop is already woken up.
+	[[maybe_unused]] const auto result = ::write(m_fd, &value, sizeof(value));
+}
+
+void event_loop::reset_wakeup() noexcept
+{
+	std::uint64_t value = 0;
+	// Fails with EAGAIN if event loop wasn't woken up.
+	[[maybe_unused]] const auto result = ::read(m_fd, &value, sizeof(value));
+}
+
+bool event_loop::wait(std::optional<time_point> deadline)
+{
+	pollfd pfd = { m_fd, POLLIN, 0 };
+	while (true)
+	{
+		int timeoutMs = -1;
+		if (deadline)
+		{
+			const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+			timeoutMs = remaining.count() > 0 ? int(remaining.count()) : 0;
+		}
+
+		const int result = ::poll(&pfd, 1, timeoutMs);
+		if (result > 0)
+		{
+			reset_wakeup();
+			return true;
+		}
+		if (result == 0)
+		{
+			return false;
+		}
+		if (errno != EINTR)
+		{
+			throw std::system_error(errno, std::generic_category(), "cannot wait for eventfd");
+		}
+	}
+}
+
+#else
+
+event_loop::event_loop() = default;
+
+event_loop::~event_loop() = default;
+
+int event_loop::fd() const noexcept
+{
+	return -1;
+}
+
+void event_loop::wakeup() noexcept
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_woken = true;
+	}
+	m_wakeup.notify_one();
+}
+
+void event_loop::reset_wakeup() noexcept
+{
+	std::lock_guard lock(m_mutex);
+	m_woken = false;
+}
+
+bool event_loop::wait(std::optional<time_point> deadline)
+{
+	std::unique_lock lock(m_mutex);
+	auto isWoken = [this] {
+		return m_woken;
+	};
+	if (deadline)
+	{
+		if (!m_wakeup.wait_until(lock, *deadline, isWoken))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		m_wakeup.wait(lock, isWoken);
+	}
+	m_woken = false;
+	return true;
+}
+
+#endif
+
+bool event_loop::wait_for_tasks(std::optional<time_point> deadline)
+{
+	if (has_pending_tasks())
+	{
+		reset_wakeup();
+		return true;
+	}
+	return wait(deadline);
+}
+
+void event_loop::run()
+{
+	while (!m_stopped.load(std::memory_order_acquire))
+	{
+		if (wait_for_tasks(std::nullopt))
+		{
+			run_queued_tasks();
+		}
+	}
+	m_stopped.store(false, std::memory_order_relaxed);
+}
+
+std::size_t event_loop::run_once()
+{
+	if (m_stopped.exchange(false, std::memory_order_acq_rel))
+	{
+		return 0;
+	}
+	wait_for_tasks(std::nullopt);
+	return run_queued_tasks();
+}
+
+std::size_t event_loop::run_until(time_point deadline)
+{
+	std::size_t count = 0;
+	while (!m_stopped.load(std::memory_order_acquire))
+	{
+		if (!wait_for_tasks(deadline))
+		{
+			break;
+		}
+		count += run_queued_tasks();
+	}
+	m_stopped.store(false, std::memory_order_relaxed);
+	return count;
+}
+
+std::size_t event_loop::poll()
+{
+	// Wakeup is reset before running tasks, so task posted while running wakes up event loop again.
+	reset_wakeup();
+	return run_queued_tasks();
+}
+
+void event_loop::stop() noexcept
+{
+	m_stopped.store(true, std::memory_order_release);
+	wakeup();
+}
+
+} // namespace is::signals
@@ -0,0 +1,181 @@
+#include "../include/event_queue.h"
+#include <limits>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace is::signals
+{
+
+namespace
+{
+// Unbounded queue starts with small pool and doubles it each time when all nodes are in use.
+constexpr std::size_t unbounded_first_chunk_size = 64;
+
+constexpr std::uint64_t tag_increment = std::uint64_t(1) << 32;
+} // namespace
+
+event_queue::event_queue()
+	: event_queue(unbounded_first_chunk_size, false)
+{
+}
+
+event_queue::event_queue(std::size_t capacity)
+	: event_queue(capacity, true)
+{
+}
+
+event_queue::event_queue(std::size_t firstChunkSize, bool bounded)
+	: m_firstChunkSize(firstChunkSize)
+	, m_bounded(bounded)
+{
+	if (firstChunkSize == 0 || firstChunkSize >= std::numeric_limits<std::uint32_t>::max())
+	{
+		throw std::invalid_argument("invalid event queue capacity");
+	}
+	// Bounded queue preallocates its single chunk, unbounded allocates the first chunk on demand.
+	if (bounded)
+	{
+		release_node(grow());
+	}
+}
+
+event_queue::~event_queue()
+{
+	while (auto* node = m_events.pop())
+	{
+		static_cast<detail::event_node*>(node)->task.reset();
+	}
+	for (std::size_t i = 0; i < m_chunkCount; ++i)
+	{
+		delete[] m_chunks[i].load(std::memory_order_relaxed);
+	}
+}
+
+bool event_queue::try_call_one()
+{
+	auto* node = static_cast<detail::event_node*>(m_events.pop());
+	if (node == nullptr)
+	{
+		return false;
+	}
+
+	struct node_releaser
+	{
+		event_queue& queue;
+		detail::event_node* node;
+
+		~node_releaser()
+		{
+			node->task.reset();
+			queue.release_node(node);
+		}
+	} releaser{ *this, node };
+
+	node->task();
+	return true;
+}
+
+bool event_queue::is_bounded() const noexcept
+{
+	return m_bounded;
+}
+
+detail::event_node* event_queue::acquire_node()
+{
+	std::uint64_t head = m_freeHead.load(std::memory_order_acquire);
+	while (true)
+	{
+		const auto ref = std::uint32_t(head);
+		if (ref == 0)
+		{
+			if (m_bounded)
+			{
+				return nullptr;
+			}
+			if (auto* node = grow())
+			{
+				return node;
+			}
+			head = m_freeHead.load(std::memory_order_acquire);
+			continue;
+		}
+
+		// Node could be taken by other producer, then nextFree is stale but CAS fails since tag changed.
+		detail::event_node* node = get_node(ref - 1);
+		const std::uint64_t next = ((head & ~std::uint64_t(0xFFFFFFFF)) + tag_increment) | node->nextFree.load(std::memory_order_relaxed);
+		if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+		{
+			return node;
+		}
+	}
+}
+
+detail::event_node* event_queue::grow()
+{
+	std::lock_guard lock(m_growMutex);
+
+	// Other producer could grow pool or consumer could release node while this one waited for lock.
+	if (std::uint32_t(m_freeHead.load(std::memory_order_acquire)) != 0)
+	{
+		return nullptr;
+	}
+	if (m_chunkCount == max_chunk_count)
+	{
+		throw std::bad_alloc();
+	}
+
+	const std::size_t firstIndex = m_firstChunkSize * ((std::size_t(1) << m_chunkCount) - 1);
+	const std::size_t size = m_firstChunkSize << m_chunkCount;
+	if (firstIndex + size >= std::numeric_limits<std::uint32_t>::max())
+	{
+		throw std::bad_alloc();
+	}
+
+	auto* chunk = new detail::event_node[size];
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		chunk[i].index = std::uint32_t(firstIndex + i);
+		chunk[i].nextFree.store(std::uint32_t(firstIndex + i + 2), std::memory_order_relaxed);
+	}
+	m_chunks[m_chunkCount].store(chunk, std::memory_order_release);
+	++m_chunkCount;
+
+	// The first node is returned to caller, others become free.
+	if (size > 1)
+	{
+		push_free_nodes(&chunk[1], &chunk[size - 1]);
+	}
+	return &chunk[0];
+}
+
+void event_queue::release_node(detail::event_node* node) noexcept
+{
+	push_free_nodes(node, node);
+}
+
+void event_queue::push_free_nodes(detail::event_node* first, detail::event_node* last) noexcept
+{
+	std::uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+	std::uint64_t next = 0;
+	do
+	{
+		last->nextFree.store(std::uint32_t(head), std::memory_order_relaxed);
+		next = ((head & ~std::uint64_t(0xFFFFFFFF)) + tag_increment) | (first->index + 1);
+	} while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+detail::event_node* event_queue::get_node(std::uint32_t index) const noexcept
+{
+	// Chunk k keeps nodes with indexes [firstChunkSize * (2^k - 1), firstChunkSize * (2^(k+1) - 1)).
+	const std::size_t block = index / m_firstChunkSize + 1;
+	std::size_t chunk = 0;
+	while ((block >> (chunk + 1)) != 0)
+	{
+		++chunk;
+	}
+	const std::size_t offset = index - m_firstChunkSize * ((std::size_t(1) << chunk) - 1);
+	return m_chunks[chunk].load(std::memory_order_acquire) + offset;
+}
+
+} // namespace is::signals
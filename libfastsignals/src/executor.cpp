@@ -0,0 +1,85 @@
+#include "../include/executor.h"
+
+namespace is::signals
+{
+
+std::size_t executor::run_queued_tasks()
+{
+	std::size_t count = 0;
+	while (m_pendingCount.load(std::memory_order_acquire) != 0)
+	{
+		bool called = false;
+		try
+		{
+			called = m_queue.try_call_one();
+		}
+		catch (...)
+		{
+			// Other tasks could be posted while queue wasn't empty, so they didn't wake up executor.
+			if (m_pendingCount.fetch_sub(1, std::memory_order_relaxed) != 1)
+			{
+				wakeup();
+			}
+			throw;
+		}
+		if (!called)
+		{
+			// Other producer pushes task right now and blocks access to tasks queued after it.
+			std::this_thread::yield();
+			continue;
+		}
+		m_pendingCount.fetch_sub(1, std::memory_order_relaxed);
+		++count;
+	}
+	return count;
+}
+
+thread_executor::thread_executor()
+{
+	m_thread = std::thread([this] {
+		run();
+	});
+}
+
+thread_executor::~thread_executor()
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_stopped = true;
+	}
+	m_wakeup.notify_one();
+	m_thread.join();
+}
+
+void thread_executor::wakeup() noexcept
+{
+	{
+		std::lock_guard lock(m_mutex);
+		m_woken = true;
+	}
+	m_wakeup.notify_one();
+}
+
+void thread_executor::run()
+{
+	while (true)
+	{
+		bool stopped = false;
+		{
+			std::unique_lock lock(m_mutex);
+			m_wakeup.wait(lock, [this] {
+				return m_woken || m_stopped;
+			});
+			m_woken = false;
+			stopped = m_stopped;
+		}
+
+		run_queued_tasks();
+		if (stopped)
+		{
+			return;
+		}
+	}
+}
+
+} // namespace is::signals
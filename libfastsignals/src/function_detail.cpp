@@ -25,6 +25,12 @@ packed_function& packed_function::operator=(packed_function&& other) noexcept
 
 base_function_proxy* packed_function::move_proxy_from(packed_function&& other) noexcept
 {
+	if (other.is_delegate())
+	{
+		new (&m_buffer) delegate_data(other.get_delegate());
+		other.m_proxy = nullptr;
+		return &delegate_marker;
+	}
 	auto proxy = other.m_proxy ? other.m_proxy->move(&m_buffer) : nullptr;
 	other.m_proxy = nullptr;
 	return proxy;
@@ -32,6 +38,11 @@ base_function_proxy* packed_function::move_proxy_from(packed_function&& other) n
 
 base_function_proxy* packed_function::clone_proxy_from(const packed_function& other)
 {
+	if (other.is_delegate())
+	{
+		new (&m_buffer) delegate_data(other.get_delegate());
+		return &delegate_marker;
+	}
 	return other.m_proxy ? other.m_proxy->clone(&m_buffer) : nullptr;
 }
 
@@ -39,7 +50,7 @@ packed_function& packed_function::operator=(const packed_function& other)
 {
 	if (this != &other)
 	{
-		if (other.is_buffer_allocated() && is_buffer_allocated())
+		if (other.is_buffer_used() && is_buffer_used())
 		{
 			// "This" and "other" are using SBO. Safe assignment must use copy+move
 			*this = packed_function(other);
@@ -66,7 +77,11 @@ void packed_function::reset() noexcept
 {
 	if (m_proxy != nullptr)
 	{
-		if (is_buffer_allocated())
+		if (is_delegate())
+		{
+			// Delegate is trivially destructible.
+		}
+		else if (is_buffer_allocated())
 		{
 			m_proxy->~base_function_proxy();
 		}
@@ -80,7 +95,7 @@ void packed_function::reset() noexcept
 
 base_function_proxy& packed_function::unwrap() const
 {
-	if (m_proxy == nullptr)
+	if (m_proxy == nullptr || is_delegate())
 	{
 		throw std::bad_function_call();
 	}
@@ -93,4 +108,65 @@ bool packed_function::is_buffer_allocated() const noexcept
 		&& std::less<const void*>()(m_proxy, &m_buffer[1]);
 }
 
+bool packed_function::is_buffer_used() const noexcept
+{
+	return is_delegate() || is_buffer_allocated();
+}
+
+packed_task::packed_task(packed_task&& other) noexcept
+	: m_proxy(move_proxy_from(std::move(other)))
+{
+}
+
+packed_task& packed_task::operator=(packed_task&& other) noexcept
+{
+	assert(this != &other);
+	reset();
+	m_proxy = move_proxy_from(std::move(other));
+	return *this;
+}
+
+packed_task::~packed_task() noexcept
+{
+	reset();
+}
+
+void packed_task::operator()() const
+{
+	if (m_proxy == nullptr)
+	{
+		throw std::bad_function_call();
+	}
+	(*m_proxy)();
+}
+
+void packed_task::reset() noexcept
+{
+	if (m_proxy != nullptr)
+	{
+		if (is_buffer_allocated())
+		{
+			m_proxy->~base_task_proxy();
+		}
+		else
+		{
+			delete m_proxy;
+		}
+		m_proxy = nullptr;
+	}
+}
+
+base_task_proxy* packed_task::move_proxy_from(packed_task&& other) noexcept
+{
+	auto proxy = other.m_proxy ? other.m_proxy->move(&m_buffer) : nullptr;
+	other.m_proxy = nullptr;
+	return proxy;
+}
+
+bool packed_task::is_buffer_allocated() const noexcept
+{
+	return std::less_equal<const void*>()(&m_buffer[0], m_proxy)
+		&& std::less<const void*>()(m_proxy, &m_buffer[1]);
+}
+
 } // namespace is::signals::detail
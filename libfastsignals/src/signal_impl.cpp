@@ -1,59 +1,933 @@
 #include "../include/signal_impl.h"
+#include "../include/thread_pool.h"
 #include <algorithm>
+#include <iterator>
 #include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace is::signals::detail
 {
 
-uint64_t signal_impl::add(packed_function fn)
+namespace
 {
-	std::lock_guard lock(m_mutex);
+// Storage never shrinks below this capacity to avoid reallocations on small signals.
+constexpr size_t min_shrink_capacity = 16;
 
-	m_functions.emplace_back(std::move(fn));
+// Segment key orders slots: ungrouped slots connected at front, then groups in ascending order,
+//  then main storage with ungrouped slots connected at back. In each group slots connected at front go first.
+constexpr uint64_t main_segment_key = uint64_t(2) << 33;
+
+uint64_t get_segment_key(bool grouped, int group, connect_position position) noexcept
+{
+	const uint64_t kind = grouped ? 1 : 0;
+	const uint64_t groupOrder = uint64_t(uint32_t(group) ^ 0x80000000u);
+	const uint64_t back = (position == connect_position::at_back) ? 1 : 0;
+	return (kind << 33) | (groupOrder << 1) | back;
+}
+
+// Segment of slots connected at front is emitted in reverse order.
+bool is_reversed_segment(uint64_t key) noexcept
+{
+	return (key & 1) == 0;
+}
+
+// Makes sure that count items can be appended to vector taken by getter without reallocation.
+// As with slots storage, new storage is allocated while mutex unlocked, then function returns true,
+//  so caller checks all its storage again. Vector is taken again after relocking, since other thread could move it.
+// Old storage is moved into released, so caller destroys it after unlocking.
+template <class T, class GetItems>
+bool reserve_found_unlocked(std::unique_lock<spin_mutex>& lock, GetItems&& getItems, size_t count, std::vector<T>& released)
+{
+	std::vector<T>* items = getItems();
+	if (items == nullptr || items->capacity() - items->size() >= count)
+	{
+		return false;
+	}
+	const size_t capacity = std::max(items->size() * 2, items->size() + std::max(count, size_t(4)));
+	lock.unlock();
+	std::vector<T>().swap(released);
+	released.reserve(capacity);
+	lock.lock();
+
+	items = getItems();
+	if (items != nullptr && items->capacity() < capacity && items->size() + count <= capacity)
+	{
+		std::move(items->begin(), items->end(), std::back_inserter(released));
+		items->swap(released);
+	}
+	return true;
+}
+
+template <class T>
+bool reserve_unlocked(std::unique_lock<spin_mutex>& lock, std::vector<T>& items, size_t count, std::vector<T>& released)
+{
+	return reserve_found_unlocked(lock, [&items] {
+		return &items;
+	}, count, released);
+}
+} // namespace
+
+signal_impl::signal_impl()
+	: m_waiters(std::make_shared<emission_waiters>())
+	, m_states(std::make_shared<slot_states>(*this))
+{
+}
+
+signal_impl::~signal_impl()
+{
+	if (m_hasHandles.load(std::memory_order_acquire))
+	{
+		std::vector<connection_table_ref> handleRefs;
+		{
+			std::lock_guard lock(m_mutex);
+			handleRefs.swap(m_handleRefs);
+		}
+		// Table doesn't start new removals once entries are released, and started ones are waited.
+		connection_table::instance().release(handleRefs);
+		while (m_handleRemovals.load(std::memory_order_acquire) != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+	m_states->detach();
+}
+
+slot_key signal_impl::add(packed_function fn)
+{
+	return add_impl(std::move(fn), nullptr);
+}
+
+slot_key signal_impl::add(packed_function fn, std::atomic<uint64_t>& sharedNextId)
+{
+	return add_impl(std::move(fn), &sharedNextId);
+}
+
+slot_key signal_impl::add_limited(packed_function fn, uint64_t callCount, connect_position position)
+{
+	if (position == connect_position::at_back)
+	{
+		return add_impl(std::move(fn), nullptr, nullptr, callCount);
+	}
+	return add_to_segment(std::move(fn), get_segment_key(false, 0, position), callCount);
+}
+
+slot_key signal_impl::add_ungrouped(packed_function fn, connect_position position)
+{
+	if (position == connect_position::at_back)
+	{
+		return add(std::move(fn));
+	}
+	return add_to_segment(std::move(fn), get_segment_key(false, 0, position));
+}
+
+slot_key signal_impl::add_to_group(packed_function fn, int group, connect_position position)
+{
+	return add_to_segment(std::move(fn), get_segment_key(true, group, position));
+}
+
+slot_key signal_impl::add_to_segment(packed_function fn, uint64_t segmentKey, uint64_t callCount)
+{
+	identity_map identityNode;
+	prepare_identity_node(fn, 0, identityNode);
+	slot_segment newSegment{ segmentKey, {}, {} };
+	released_slots released;
+	slot_states::chunk_ptr spareChunk;
+	std::unique_lock lock(m_mutex);
+
+	const auto findSegment = [this, segmentKey] {
+		return std::lower_bound(m_segments.begin(), m_segments.end(), segmentKey, [](const slot_segment& segment, uint64_t key) {
+			return segment.key < key;
+		});
+	};
+	const auto getSegmentItems = [this, segmentKey, &findSegment](auto member) {
+		return [this, segmentKey, &findSegment, member] {
+			const auto segment = findSegment();
+			return (segment != m_segments.end() && segment->key == segmentKey) ? &((*segment).*member) : nullptr;
+		};
+	};
+
+	// Everything is allocated while mutex unlocked, so storage is checked again until all of it is available under the same lock.
+	// Slot is appended to its segment only, other segments and main storage aren't moved.
+	while (true)
+	{
+		const auto segment = findSegment();
+		if (segment == m_segments.end() || segment->key != segmentKey)
+		{
+			if (reserve_unlocked(lock, m_segments, 1, released.segments))
+			{
+				continue;
+			}
+			if (newSegment.functions.capacity() == 0)
+			{
+				lock.unlock();
+				newSegment.functions.reserve(4);
+				newSegment.ids.reserve(4);
+				lock.lock();
+				continue;
+			}
+		}
+		else if (reserve_found_unlocked(lock, getSegmentItems(&slot_segment::functions), 1, released.functions)
+			|| reserve_found_unlocked(lock, getSegmentItems(&slot_segment::ids), 1, released.ids))
+		{
+			continue;
+		}
+		if (callCount != 0 && reserve_unlocked(lock, m_callLimits, 1, released.callLimits))
+		{
+			continue;
+		}
+		if (!m_states->has_free_entry())
+		{
+			m_states->reserve_entry(lock, spareChunk);
+			continue;
+		}
+		break;
+	}
+	prepare_connect_locked(released);
+	// Index entry is the last allocation, so nothing throws after it's added.
+	const auto identity = insert_identity_locked(identityNode);
+
+	auto segment = findSegment();
+	if (segment == m_segments.end() || segment->key != segmentKey)
+	{
+		segment = m_segments.insert(segment, std::move(newSegment));
+	}
+
+	const uint64_t id = m_nextId++;
+	segment->functions.push_back(std::move(fn));
+	segment->ids.push_back(id);
+	const slot_key key = { id, m_states->acquire(id) };
+	if (callCount != 0)
+	{
+		// Segment slot has the greatest id, so limits stay sorted by id.
+		m_callLimits.push_back({ id, callCount, key.index });
+	}
+	if (identity != m_identities.end())
+	{
+		identity->second = key;
+	}
+	return key;
+}
+
+const slot_states_ptr& signal_impl::states() const noexcept
+{
+	return m_states;
+}
 
+connection_handle_data signal_impl::add_with_handle(packed_function fn)
+{
+	auto& table = connection_table::instance();
+	// Table entry taken before signal locked, so table and signal are never locked together.
+	const connection_handle_data handle = table.acquire(this);
 	try
 	{
-		m_ids.emplace_back(m_nextId);
+		const uint64_t id = add_impl(std::move(fn), nullptr, &handle).id;
+		table.set_slot_id(handle, id);
 	}
-	catch (const std::bad_alloc& /*e*/)
+	catch (...)
+	{
+		table.release(handle);
+		throw;
+	}
+	return handle;
+}
+
+void signal_impl::add_with_handles(span<packed_function> fns, std::vector<connection_handle_data>& handles)
+{
+	if (fns.empty())
+	{
+		return;
+	}
+
+	auto& table = connection_table::instance();
+	const size_t firstHandle = handles.size();
+	table.acquire(this, fns.size(), handles);
+	const span<const connection_handle_data> acquired(handles.data() + firstHandle, fns.size());
+	try
+	{
+		const uint64_t firstId = add_range_impl(fns, acquired);
+		table.set_slot_ids(acquired, firstId);
+	}
+	catch (...)
 	{
-		// Remove function since we failed to add its id
-		m_functions.pop_back();
+		table.release(acquired);
+		handles.resize(firstHandle);
 		throw;
 	}
+}
+
+uint64_t signal_impl::add_range_impl(span<packed_function> fns, span<const connection_handle_data> handles)
+{
+	// Index entries keep slot index in range until slot ids are known.
+	identity_map identityNodes;
+	for (size_t i = 0; i < fns.size(); ++i)
+	{
+		prepare_identity_node(fns[i], i, identityNodes);
+	}
+	released_slots released;
+	std::unique_lock lock(m_mutex);
+
+	// Storage is allocated while mutex unlocked, so it's checked again until all of it is available under the same lock.
+	while (true)
+	{
+		if (m_ids.size() + fns.size() > capacity_locked())
+		{
+			reallocate_locked(lock, std::max(m_ids.size() * 2, m_ids.size() + fns.size()), released);
+			continue;
+		}
+		if (reserve_unlocked(lock, m_handleRefs, handles.size(), released.handleRefs))
+		{
+			continue;
+		}
+		break;
+	}
+	prepare_connect_locked(released);
+
+	// Buckets are reserved first, so inserting prepared entries cannot throw.
+	const uint64_t firstId = m_nextId;
+	m_identities.reserve(m_identities.size() + identityNodes.size());
+	while (!identityNodes.empty())
+	{
+		auto node = identityNodes.extract(identityNodes.begin());
+		node.mapped().id += firstId;
+		m_identities.insert(std::move(node));
+	}
+
+	// Cannot throw since capacity is enough for all vectors.
+	for (size_t i = 0; i < fns.size(); ++i)
+	{
+		const uint64_t id = firstId + i;
+		m_functions.emplace_back(std::move(fns[i]));
+		m_ids.emplace_back(id);
+		m_handleRefs.push_back({ id, handles[i] });
+	}
+	m_nextId = firstId + fns.size();
+	m_hasHandles.store(true, std::memory_order_release);
 
-	return m_nextId++;
+	return firstId;
 }
 
-void signal_impl::remove(uint64_t id) noexcept
+slot_key signal_impl::add_impl(packed_function fn, std::atomic<uint64_t>* sharedNextId, const connection_handle_data* handle, uint64_t callCount)
 {
-	std::lock_guard lock(m_mutex);
+	identity_map identityNode;
+	prepare_identity_node(fn, 0, identityNode);
+	released_slots released;
+	slot_states::chunk_ptr spareChunk;
+	std::unique_lock lock(m_mutex);
 
+	// Slots storage, state entry and other vectors are allocated while mutex unlocked,
+	//  so they are checked again until all of them are available under the same lock.
+	while (true)
+	{
+		if (m_ids.size() >= capacity_locked())
+		{
+			reallocate_locked(lock, std::max(m_ids.size() * 2, size_t(1)), released);
+			continue;
+		}
+		if (handle)
+		{
+			if (reserve_unlocked(lock, m_handleRefs, 1, released.handleRefs))
+			{
+				continue;
+			}
+		}
+		else
+		{
+			if (callCount != 0 && reserve_unlocked(lock, m_callLimits, 1, released.callLimits))
+			{
+				continue;
+			}
+			if (!m_states->has_free_entry())
+			{
+				m_states->reserve_entry(lock, spareChunk);
+				continue;
+			}
+		}
+		break;
+	}
+	prepare_connect_locked(released);
+	// Index entry is the last allocation, so nothing throws after it's added.
+	const auto identity = insert_identity_locked(identityNode);
+
+	// Shared id is taken under lock, so ids are still sorted within this signal.
+	const uint64_t id = sharedNextId ? sharedNextId->fetch_add(1, std::memory_order_relaxed) : m_nextId;
+
+	// Cannot throw since capacity is enough for both vectors.
+	m_functions.emplace_back(std::move(fn));
+	m_ids.emplace_back(id);
+	m_nextId = id + 1;
+	slot_key key = { id };
+	if (handle)
+	{
+		m_handleRefs.push_back({ id, *handle });
+		m_hasHandles.store(true, std::memory_order_release);
+	}
+	else
+	{
+		key.index = m_states->acquire(id);
+		if (callCount != 0)
+		{
+			m_callLimits.push_back({ id, callCount, key.index });
+		}
+	}
+	if (identity != m_identities.end())
+	{
+		identity->second = key;
+	}
+	return key;
+}
+
+void signal_impl::prepare_identity_node(const packed_function& fn, uint64_t index, identity_map& nodes)
+{
+	size_t identityHash = 0;
+	if (fn.get_identity_hash(identityHash))
+	{
+		nodes.emplace(identityHash, slot_key{ index });
+	}
+}
+
+signal_impl::identity_map::iterator signal_impl::insert_identity_locked(identity_map& node)
+{
+	if (node.empty())
+	{
+		return m_identities.end();
+	}
+	// Entry is allocated before locking, only bucket array grows under lock and as rarely as vector does.
+	return m_identities.insert(node.extract(node.begin()));
+}
+
+void signal_impl::prepare_connect_locked(released_slots& released)
+{
+	if (m_frozen.load(std::memory_order_relaxed))
+	{
+		if (m_freezePolicy == freeze_policy::throw_on_connect)
+		{
+			throw std::logic_error("cannot connect slot to frozen signal");
+		}
+		unfreeze_locked(released);
+	}
+}
+
+void signal_impl::remove(slot_key key, packed_function& removedFunction, released_storage_ptr& releasedStorage) noexcept
+{
+	released_slots released;
+	std::unique_lock lock(m_mutex);
+	remove_locked(lock, key, removedFunction, released);
+	// Snapshots keep copies of slots, which are destroyed by caller after slot states unlocked.
+	releasedStorage = std::move(released.snapshots);
+}
+
+void signal_impl::remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& releasedStorage) noexcept
+{
+	if (keys.empty())
+	{
+		return;
+	}
+
+	released_slots released;
+	std::unique_lock lock(m_mutex);
+
+	// Both id sequences are sorted, so slots are compacted in one pass starting from the first removed one.
+	const slot_key* removedKey = keys.begin();
+	size_t kept = std::distance(m_ids.begin(), std::lower_bound(m_ids.begin(), m_ids.end(), removedKey->id));
+	for (size_t i = kept; i < m_ids.size(); ++i)
+	{
+		while (removedKey != keys.end() && removedKey->id < m_ids[i])
+		{
+			++removedKey;
+		}
+		if (removedKey != keys.end() && removedKey->id == m_ids[i])
+		{
+			removedFunctions.push_back(std::move(m_functions[i]));
+			erase_identity_locked(m_ids[i], removedFunctions.back());
+			m_states->release(*removedKey);
+			++removedKey;
+			continue;
+		}
+		if (kept != i)
+		{
+			m_ids[kept] = m_ids[i];
+			m_functions[kept] = std::move(m_functions[i]);
+		}
+		++kept;
+	}
+
+	m_ids.erase(m_ids.begin() + kept, m_ids.end());
+	m_functions.erase(m_functions.begin() + kept, m_functions.end());
+	if (!m_segments.empty())
+	{
+		for (const slot_key& key : keys)
+		{
+			packed_function removedFunction;
+			if (remove_from_segments_locked(key, removedFunction))
+			{
+				removedFunctions.push_back(std::move(removedFunction));
+			}
+		}
+	}
+
+	if (removedFunctions.empty())
+	{
+		return;
+	}
+	if (!m_callLimits.empty())
+	{
+		const auto removed = std::remove_if(m_callLimits.begin(), m_callLimits.end(), [keys](const call_limit& limit) {
+			return std::binary_search(keys.begin(), keys.end(), slot_key{ limit.slotId }, [](const slot_key& lhs, const slot_key& rhs) {
+				return lhs.id < rhs.id;
+			});
+		});
+		m_callLimits.erase(removed, m_callLimits.end());
+	}
+	unfreeze_locked(released);
+	releasedStorage = std::move(released.snapshots);
+
+	if (m_shrinkPolicy == shrink_policy::automatic)
+	{
+		shrink_locked(lock, released);
+	}
+}
+
+void signal_impl::begin_remove_with_handle() noexcept
+{
+	m_handleRemovals.fetch_add(1, std::memory_order_relaxed);
+}
+
+void signal_impl::remove_with_handle(uint64_t id, packed_function& removedFunction) noexcept
+{
+	released_slots released;
+	{
+		std::unique_lock lock(m_mutex);
+
+		auto ref = std::lower_bound(m_handleRefs.begin(), m_handleRefs.end(), id, [](const connection_table_ref& ref, uint64_t id) {
+			return ref.slotId < id;
+		});
+		if (ref != m_handleRefs.end() && ref->slotId == id)
+		{
+			m_handleRefs.erase(ref);
+		}
+		remove_locked(lock, { id }, removedFunction, released);
+	}
+	// Released slots are destroyed after this, when signal can be already destroyed.
+	m_handleRemovals.fetch_sub(1, std::memory_order_release);
+}
+
+void signal_impl::remove_locked(std::unique_lock<spin_mutex>& lock, slot_key key, packed_function& removedFunction, released_slots& released) noexcept
+{
 	// We use binary search because ids array is always sorted.
-	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
-	if (it != m_ids.end() && *it == id)
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), key.id);
+	if (it != m_ids.end() && *it == key.id)
 	{
 		size_t i = std::distance(m_ids.begin(), it);
+		removedFunction = std::move(m_functions[i]);
+		erase_identity_locked(key.id, removedFunction);
+		m_states->release(key);
 		m_ids.erase(m_ids.begin() + i);
 		m_functions.erase(m_functions.begin() + i);
+		erase_call_limit_locked(key.id);
+		unfreeze_locked(released);
+
+		if (m_shrinkPolicy == shrink_policy::automatic)
+		{
+			shrink_locked(lock, released);
+		}
+	}
+	else if (!m_segments.empty() && remove_from_segments_locked(key, removedFunction))
+	{
+		erase_call_limit_locked(key.id);
+		unfreeze_locked(released);
+	}
+}
+
+bool signal_impl::remove_from_segments_locked(slot_key key, packed_function& removedFunction) noexcept
+{
+	for (auto segment = m_segments.begin(); segment != m_segments.end(); ++segment)
+	{
+		auto it = std::lower_bound(segment->ids.begin(), segment->ids.end(), key.id);
+		if (it == segment->ids.end() || *it != key.id)
+		{
+			continue;
+		}
+		const size_t i = std::distance(segment->ids.begin(), it);
+		removedFunction = std::move(segment->functions[i]);
+		erase_identity_locked(key.id, removedFunction);
+		m_states->release(key);
+		segment->ids.erase(it);
+		segment->functions.erase(segment->functions.begin() + i);
+		if (segment->ids.empty())
+		{
+			// Empty segment owns no slots, so it's destroyed under lock.
+			m_segments.erase(segment);
+		}
+		return true;
+	}
+	return false;
+}
+
+const packed_function* signal_impl::find_slot_locked(uint64_t id) const noexcept
+{
+	auto it = std::lower_bound(m_ids.begin(), m_ids.end(), id);
+	if (it != m_ids.end() && *it == id)
+	{
+		return &m_functions[std::distance(m_ids.begin(), it)];
+	}
+	for (const auto& segment : m_segments)
+	{
+		auto segmentIt = std::lower_bound(segment.ids.begin(), segment.ids.end(), id);
+		if (segmentIt != segment.ids.end() && *segmentIt == id)
+		{
+			return &segment.functions[std::distance(segment.ids.begin(), segmentIt)];
+		}
+	}
+	return nullptr;
+}
+
+const connection_table_ref* signal_impl::find_handle_ref_locked(uint64_t id) const noexcept
+{
+	auto ref = std::lower_bound(m_handleRefs.begin(), m_handleRefs.end(), id, [](const connection_table_ref& ref, uint64_t id) {
+		return ref.slotId < id;
+	});
+	return (ref != m_handleRefs.end() && ref->slotId == id) ? &*ref : nullptr;
+}
+
+void signal_impl::erase_identity_locked(uint64_t id, const packed_function& fn) noexcept
+{
+	size_t hash = 0;
+	if (m_identities.empty() || !fn.get_identity_hash(hash))
+	{
+		return;
+	}
+	const auto range = m_identities.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second.id == id)
+		{
+			m_identities.erase(it);
+			return;
+		}
+	}
+}
+
+bool signal_impl::count_call_locked(uint64_t id) noexcept
+{
+	auto limit = std::lower_bound(m_callLimits.begin(), m_callLimits.end(), id, [](const call_limit& limit, uint64_t id) {
+		return limit.slotId < id;
+	});
+	if (limit == m_callLimits.end() || limit->slotId != id || --limit->remainingCalls != 0)
+	{
+		return false;
+	}
+	m_states->release({ id, limit->stateIndex });
+	m_callLimits.erase(limit);
+	return true;
+}
+
+void signal_impl::retire_called_slots_locked(std::vector<packed_function>& retiredSlots)
+{
+	if (m_callLimits.empty())
+	{
+		return;
+	}
+	const auto isLastCall = [](const call_limit& limit) {
+		return limit.remainingCalls == 1;
+	};
+	retiredSlots.reserve(std::count_if(m_callLimits.begin(), m_callLimits.end(), isLastCall));
+	for (call_limit& limit : m_callLimits)
+	{
+		--limit.remainingCalls;
+	}
+
+	// Both limits and main storage are sorted by id, so retired slots are removed in one pass.
+	// Limits of slots connected at front are skipped here, since these slots are kept in segment.
+	auto limit = m_callLimits.begin();
+	size_t kept = 0;
+	for (size_t i = 0; i < m_ids.size(); ++i)
+	{
+		while (limit != m_callLimits.end() && limit->slotId < m_ids[i])
+		{
+			++limit;
+		}
+		if (limit != m_callLimits.end() && limit->slotId == m_ids[i] && limit->remainingCalls == 0)
+		{
+			m_states->release({ limit->slotId, limit->stateIndex });
+			retiredSlots.push_back(std::move(m_functions[i]));
+			erase_identity_locked(limit->slotId, retiredSlots.back());
+			continue;
+		}
+		if (kept != i)
+		{
+			m_ids[kept] = m_ids[i];
+			m_functions[kept] = std::move(m_functions[i]);
+		}
+		++kept;
+	}
+	m_ids.erase(m_ids.begin() + kept, m_ids.end());
+	m_functions.erase(m_functions.begin() + kept, m_functions.end());
+	if (!m_segments.empty())
+	{
+		for (const call_limit& retired : m_callLimits)
+		{
+			packed_function removedFunction;
+			if (retired.remainingCalls == 0 && remove_from_segments_locked({ retired.slotId, retired.stateIndex }, removedFunction))
+			{
+				retiredSlots.push_back(std::move(removedFunction));
+			}
+		}
+	}
+	m_callLimits.erase(std::remove_if(m_callLimits.begin(), m_callLimits.end(), [](const call_limit& limit) {
+		return limit.remainingCalls == 0;
+	}), m_callLimits.end());
+}
+
+void signal_impl::erase_call_limit_locked(uint64_t id) noexcept
+{
+	auto limit = std::lower_bound(m_callLimits.begin(), m_callLimits.end(), id, [](const call_limit& limit, uint64_t id) {
+		return limit.slotId < id;
+	});
+	if (limit != m_callLimits.end() && limit->slotId == id)
+	{
+		m_callLimits.erase(limit);
 	}
 }
 
 void signal_impl::remove_all() noexcept
+{
+	released_slots released;
+	std::vector<slot_segment> segments;
+	std::vector<connection_table_ref> handleRefs;
+	std::unordered_multimap<size_t, slot_key> identities;
+	{
+		std::lock_guard lock(m_mutex);
+		unfreeze_locked(released);
+		if (m_shrinkPolicy == shrink_policy::automatic && m_reservedCapacity == 0)
+		{
+			released.functions.swap(m_functions);
+			released.ids.swap(m_ids);
+		}
+		else
+		{
+			m_functions.clear();
+			m_ids.clear();
+		}
+		segments.swap(m_segments);
+		handleRefs.swap(m_handleRefs);
+		identities.swap(m_identities);
+		m_callLimits.clear();
+		m_states->release_all();
+	}
+
+	// Table is locked after signal unlocked, so table and signal are never locked together.
+	if (!handleRefs.empty())
+	{
+		connection_table::instance().release(handleRefs);
+	}
+}
+
+void signal_impl::reserve(size_t capacity)
+{
+	released_slots released;
+	std::unique_lock lock(m_mutex);
+
+	m_reservedCapacity = capacity;
+	while (capacity_locked() < capacity)
+	{
+		reallocate_locked(lock, capacity, released);
+	}
+}
+
+void signal_impl::shrink_to_fit() noexcept
+{
+	released_slots released;
+	std::unique_lock lock(m_mutex);
+
+	m_reservedCapacity = 0;
+	if (m_ids.size() < capacity_locked())
+	{
+		try
+		{
+			reallocate_locked(lock, m_ids.size(), released);
+		}
+		catch (const std::bad_alloc& /*e*/)
+		{
+			// Shrinking is an optimization, signal still works with old storage.
+		}
+	}
+}
+
+void signal_impl::set_shrink_policy(shrink_policy policy) noexcept
+{
+	std::lock_guard lock(m_mutex);
+	m_shrinkPolicy = policy;
+}
+
+size_t signal_impl::capacity() const noexcept
 {
 	std::lock_guard lock(m_mutex);
-	m_functions.clear();
-	m_ids.clear();
+	return capacity_locked();
 }
 
-bool signal_impl::get_next_slot(packed_function& slot, size_t& expectedIndex, uint64_t& nextId) const
+size_t signal_impl::capacity_locked() const noexcept
+{
+	return std::min(m_functions.capacity(), m_ids.capacity());
+}
+
+void signal_impl::reallocate_locked(std::unique_lock<spin_mutex>& lock, size_t capacity, released_slots& released)
+{
+	// Memory allocated while mutex unlocked, so emission and disconnection on other threads aren't blocked.
+	// Only moving slots into new storage happens under lock.
+	released_slots storage;
+	lock.unlock();
+	// Storage released by previous attempt is destroyed while mutex unlocked too.
+	std::vector<packed_function>().swap(released.functions);
+	std::vector<uint64_t>().swap(released.ids);
+	storage.functions.reserve(capacity);
+	storage.ids.reserve(capacity);
+	lock.lock();
+
+	// Other thread could add slots while mutex was unlocked, caller will try again with larger capacity.
+	if (m_ids.size() <= capacity)
+	{
+		std::move(m_functions.begin(), m_functions.end(), std::back_inserter(storage.functions));
+		storage.ids.assign(m_ids.begin(), m_ids.end());
+		m_functions.swap(storage.functions);
+		m_ids.swap(storage.ids);
+	}
+	released.functions = std::move(storage.functions);
+	released.ids = std::move(storage.ids);
+}
+
+void signal_impl::shrink_locked(std::unique_lock<spin_mutex>& lock, released_slots& released) noexcept
+{
+	// Shrink only when storage is mostly unused, so connect/disconnect sequences don't cause reallocations.
+	const size_t capacity = capacity_locked();
+	if (capacity <= min_shrink_capacity || m_ids.size() > capacity / 4 || capacity <= m_reservedCapacity)
+	{
+		return;
+	}
+
+	try
+	{
+		reallocate_locked(lock, std::max({ m_ids.size() * 2, m_reservedCapacity, min_shrink_capacity }), released);
+	}
+	catch (const std::bad_alloc& /*e*/)
+	{
+		// Shrinking is an optimization, signal still works with old storage.
+	}
+}
+
+bool signal_impl::get_next_slot(packed_function& slot, size_t& expectedIndex, uint64_t& nextId, uint64_t maxId)
 {
 	// Slots always arranged by ID, so we can use a simple algorithm which avoids races:
 	//  - on each step find first slot with ID >= slotId
 	//  - after each call increment slotId
 
+	// Previous slot may be the last owner of retired slot, so it's destroyed before mutex locked.
+	slot.reset();
 	std::lock_guard lock(m_mutex);
+	return get_next_main_slot_locked(slot, expectedIndex, nextId, maxId);
+}
+
+bool signal_impl::get_next_slot(packed_function& slot, slot_cursor& cursor)
+{
+	slot.reset();
+	std::lock_guard lock(m_mutex);
+
+	if (cursor.segmentKey != main_segment_key)
+	{
+		if (get_next_segment_slot_locked(slot, cursor))
+		{
+			return true;
+		}
+		cursor.segmentKey = main_segment_key;
+		cursor.index = 0;
+		cursor.nextId = 1;
+	}
+	return get_next_main_slot_locked(slot, cursor.index, cursor.nextId, std::numeric_limits<uint64_t>::max());
+}
+
+bool signal_impl::get_next_segment_slot_locked(packed_function& slot, slot_cursor& cursor)
+{
+	// Segments are found by key on each step, since other segments can be added or removed between mutex locks.
+	auto segment = std::lower_bound(m_segments.begin(), m_segments.end(), cursor.segmentKey, [](const slot_segment& segment, uint64_t key) {
+		return segment.key < key;
+	});
+	for (; segment != m_segments.end(); ++segment)
+	{
+		const bool reversed = is_reversed_segment(segment->key);
+		const auto& ids = segment->ids;
+		if (segment->key != cursor.segmentKey || cursor.nextId == 0)
+		{
+			cursor.segmentKey = segment->key;
+			// Slots connected at front during emission have greater ids, so emission doesn't reach them.
+			cursor.nextId = reversed ? m_nextId : 1;
+			cursor.index = reversed ? ids.size() : 0;
+		}
+
+		if (reversed)
+		{
+			// Index points after the next slot, so slot at index - 1 must have the greatest id less than nextId.
+			const bool isValidIndex = cursor.index <= ids.size()
+				&& (cursor.index == 0 || ids[cursor.index - 1] < cursor.nextId)
+				&& (cursor.index == ids.size() || ids[cursor.index] >= cursor.nextId);
+			if (!isValidIndex)
+			{
+				cursor.index = std::distance(ids.begin(), std::lower_bound(ids.begin(), ids.end(), cursor.nextId));
+			}
+			if (cursor.index != 0)
+			{
+				// Slots with lesser ids keep their indexes even if this slot is removed.
+				--cursor.index;
+				cursor.nextId = ids[cursor.index];
+				take_segment_slot_locked(slot, segment, cursor.index);
+				return true;
+			}
+		}
+		else
+		{
+			if (cursor.index >= ids.size() || ids[cursor.index] != cursor.nextId)
+			{
+				cursor.index = std::distance(ids.begin(), std::lower_bound(ids.begin(), ids.end(), cursor.nextId));
+			}
+			if (cursor.index < ids.size())
+			{
+				cursor.nextId = (cursor.index + 1 < ids.size()) ? ids[cursor.index + 1] : ids[cursor.index] + 1;
+				if (!take_segment_slot_locked(slot, segment, cursor.index))
+				{
+					++cursor.index;
+				}
+				return true;
+			}
+		}
+		// Current segment is finished, the next one starts from its beginning.
+		cursor.nextId = 0;
+	}
+	return false;
+}
+
+bool signal_impl::take_segment_slot_locked(packed_function& slot, std::vector<slot_segment>::iterator segment, size_t index) noexcept
+{
+	const uint64_t id = segment->ids[index];
+	if (m_callLimits.empty() || !count_call_locked(id))
+	{
+		slot = segment->functions[index];
+		return false;
+	}
 
+	// Slot which makes its last call is retired in the same locked step, so no other emission calls it.
+	slot = std::move(segment->functions[index]);
+	erase_identity_locked(id, slot);
+	segment->ids.erase(segment->ids.begin() + index);
+	segment->functions.erase(segment->functions.begin() + index);
+	if (segment->ids.empty())
+	{
+		// Emission finds the next segment by key, so it doesn't need removed one.
+		m_segments.erase(segment);
+	}
+	return true;
+}
+
+bool signal_impl::get_next_main_slot_locked(packed_function& slot, size_t& expectedIndex, uint64_t& nextId, uint64_t maxId)
+{
 	// Avoid binary search if next slot wasn't moved between mutex locks.
 	if (expectedIndex >= m_ids.size() || m_ids[expectedIndex] != nextId)
 	{
@@ -67,18 +941,227 @@ bool signal_impl::get_next_slot(packed_function& slot, size_t& expectedIndex, ui
 		expectedIndex = std::distance(m_ids.cbegin(), it);
 	}
 
-	slot.reset();
+	// Caller is not ready for this slot yet, so just tell slot id.
+	if (m_ids[expectedIndex] > maxId)
+	{
+		nextId = m_ids[expectedIndex];
+		return false;
+	}
+
+	// Slot which makes its last call is retired in the same locked step, so no other emission calls it.
+	if (!m_callLimits.empty() && count_call_locked(m_ids[expectedIndex]))
+	{
+		slot = std::move(m_functions[expectedIndex]);
+		erase_identity_locked(m_ids[expectedIndex], slot);
+		m_ids.erase(m_ids.begin() + expectedIndex);
+		m_functions.erase(m_functions.begin() + expectedIndex);
+		nextId = (expectedIndex < m_ids.size()) ? m_ids[expectedIndex] : m_nextId;
+		return true;
+	}
+
 	slot = m_functions[expectedIndex];
-	nextId = (expectedIndex + 1 < m_ids.size()) ? m_ids[expectedIndex + 1] : m_ids[expectedIndex] + 1;
+	// Any slot connected later will have id not less than m_nextId.
+	nextId = (expectedIndex + 1 < m_ids.size()) ? m_ids[expectedIndex + 1] : m_nextId;
 	++expectedIndex;
 	return true;
 }
 
+void signal_impl::freeze(freeze_policy policy)
+{
+	released_slots released;
+	std::lock_guard lock(m_mutex);
+
+	m_freezePolicy = policy;
+	if (m_frozen.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	// Frozen slots are called without lock, so they can't count calls.
+	if (!m_callLimits.empty())
+	{
+		throw std::logic_error("cannot freeze signal with slots connected by connect_once() or connect_n()");
+	}
+
+	auto snapshot = std::make_unique<frozen_snapshot>();
+	copy_slots_locked(snapshot->slots);
+	if (!m_frozenReaders)
+	{
+		m_frozenReaders = std::make_unique<frozen_reader_count[]>(frozen_reader_count_number);
+	}
+	m_snapshot = std::move(snapshot);
+	m_frozen.store(&m_snapshot->slots, std::memory_order_seq_cst);
+	take_unused_snapshots_locked(released.snapshots);
+}
+
+void signal_impl::unfreeze() noexcept
+{
+	released_slots released;
+	std::lock_guard lock(m_mutex);
+	unfreeze_locked(released);
+}
+
+bool signal_impl::is_frozen() const noexcept
+{
+	return m_frozen.load(std::memory_order_acquire) != nullptr;
+}
+
+void signal_impl::unfreeze_locked(released_slots& released) noexcept
+{
+	if (!m_snapshot)
+	{
+		return;
+	}
+	// Emissions which already started keep using snapshot, new emissions will use mutable slots.
+	m_frozen.store(nullptr, std::memory_order_seq_cst);
+	m_snapshot->nextRetired = std::move(m_retiredSnapshots);
+	m_retiredSnapshots = std::move(m_snapshot);
+	m_hasRetiredSnapshots.store(true, std::memory_order_seq_cst);
+	take_unused_snapshots_locked(released.snapshots);
+}
+
+void signal_impl::release_frozen_reader(std::atomic<uint32_t>& count) noexcept
+{
+	// The last emission of each counter tries to release snapshots retired meanwhile,
+	//  so the last emission which iterated frozen slots releases them.
+	if (count.fetch_sub(1, std::memory_order_seq_cst) == 1 && m_hasRetiredSnapshots.load(std::memory_order_seq_cst))
+	{
+		released_slots released;
+		std::lock_guard lock(m_mutex);
+		take_unused_snapshots_locked(released.snapshots);
+	}
+}
+
+void signal_impl::take_unused_snapshots_locked(frozen_snapshot_ptr& snapshots) noexcept
+{
+	// Retired snapshot isn't pointed by m_frozen anymore, so emission which increments counter after this check
+	//  loads pointer to current snapshot. Emission which incremented counter before keeps it above zero.
+	if (snapshots || !m_retiredSnapshots)
+	{
+		return;
+	}
+	for (size_t i = 0; i < frozen_reader_count_number; ++i)
+	{
+		if (m_frozenReaders[i].value.load(std::memory_order_seq_cst) != 0)
+		{
+			return;
+		}
+	}
+	snapshots = std::move(m_retiredSnapshots);
+	m_hasRetiredSnapshots.store(false, std::memory_order_seq_cst);
+}
+
+void signal_impl::set_parallel_emission(std::shared_ptr<thread_pool> pool, size_t slotsPerTask) noexcept
+{
+	// Previous pool released after mutex unlocked since its destructor waits for worker threads.
+	std::unique_lock lock(m_mutex);
+	m_parallelPool.swap(pool);
+	m_slotsPerTask = std::max(slotsPerTask, size_t(1));
+	m_parallelEmission.store(m_parallelPool != nullptr, std::memory_order_relaxed);
+	lock.unlock();
+}
+
+bool signal_impl::wait_until(std::chrono::steady_clock::time_point deadline) const
+{
+	return m_waiters->wait_until(deadline);
+}
+
+void signal_impl::wait() const
+{
+	m_waiters->wait();
+}
+
+void signal_impl::block() noexcept
+{
+	m_blockCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void signal_impl::unblock() noexcept
+{
+	m_blockCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void signal_impl::add_deferral() noexcept
+{
+	m_deferralCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void signal_impl::remove_deferral() noexcept
+{
+	m_deferralCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void signal_impl::get_parallel_emission(parallel_emission& emission)
+{
+	// Slots are copied under lock, so slots connected and disconnected during emission don't affect it.
+	std::lock_guard lock(m_mutex);
+	emission.pool = m_parallelPool;
+	emission.slotsPerTask = m_slotsPerTask;
+	if (m_frozen.load(std::memory_order_relaxed))
+	{
+		emission.reader.emplace(*this);
+		emission.slots = emission.reader->slots();
+	}
+	else
+	{
+		copy_slots_locked(emission.copiedSlots);
+		emission.slots = &emission.copiedSlots;
+		retire_called_slots_locked(emission.retiredSlots);
+	}
+}
+
+void signal_impl::run_parallel_emission(const parallel_emission& emission, const function<void(size_t, size_t)>& body) const
+{
+	if (!emission.pool)
+	{
+		// Parallel emission was turned off after check in invoke().
+		body(0, emission.slots->size());
+		return;
+	}
+	emission.pool->parallel_for(emission.slots->size(), emission.slotsPerTask, body);
+}
+
+void signal_impl::post_parallel_task(const parallel_emission& emission, function<void()> task) const
+{
+	emission.pool->post(std::move(task));
+}
+
+void signal_impl::copy_slots_locked(std::vector<packed_function>& slots) const
+{
+	if (m_segments.empty())
+	{
+		slots = m_functions;
+		return;
+	}
+	size_t size = m_functions.size();
+	for (const slot_segment& segment : m_segments)
+	{
+		size += segment.functions.size();
+	}
+	slots.reserve(size);
+	for (const slot_segment& segment : m_segments)
+	{
+		if (is_reversed_segment(segment.key))
+		{
+			slots.insert(slots.end(), segment.functions.rbegin(), segment.functions.rend());
+		}
+		else
+		{
+			slots.insert(slots.end(), segment.functions.begin(), segment.functions.end());
+		}
+	}
+	slots.insert(slots.end(), m_functions.begin(), m_functions.end());
+}
+
 size_t signal_impl::count() const noexcept
 {
 	std::lock_guard lock(m_mutex);
 
-	return m_functions.size();
+	size_t count = m_functions.size();
+	for (const slot_segment& segment : m_segments)
+	{
+		count += segment.functions.size();
+	}
+	return count;
 }
 
 } // namespace is::signals::detail
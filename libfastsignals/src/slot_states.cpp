@@ -0,0 +1,154 @@
+#include "../include/slot_states.h"
+#include <mutex>
+#include <new>
+
+namespace is::signals::detail
+{
+
+slot_states::slot_states(slot_owner& signal) noexcept
+	: m_signal(&signal)
+{
+}
+
+slot_states::~slot_states()
+{
+	for (size_t i = 0; i < m_chunkCount; ++i)
+	{
+		delete[] m_chunks[i].load(std::memory_order_relaxed);
+	}
+}
+
+void slot_states::disconnect(slot_key key) noexcept
+{
+	// Slot and its copies destroyed after mutex unlocked, so their destructors can disconnect other slots.
+	packed_function removedFunction;
+	released_storage_ptr releasedStorage;
+	std::lock_guard lock(m_signalMutex);
+	if (m_signal)
+	{
+		m_signal->remove(key, removedFunction, releasedStorage);
+	}
+}
+
+void slot_states::disconnect(span<const slot_key> keys) noexcept
+{
+	std::vector<packed_function> removedFunctions;
+	try
+	{
+		removedFunctions.reserve(keys.size());
+	}
+	catch (const std::bad_alloc& /*e*/)
+	{
+		for (const slot_key& key : keys)
+		{
+			disconnect(key);
+		}
+		return;
+	}
+
+	released_storage_ptr releasedStorage;
+	std::lock_guard lock(m_signalMutex);
+	if (m_signal)
+	{
+		m_signal->remove(keys, removedFunctions, releasedStorage);
+	}
+}
+
+void slot_states::detach() noexcept
+{
+	{
+		std::lock_guard lock(m_signalMutex);
+		m_signal = nullptr;
+	}
+	// Signal is being destroyed, so nobody else modifies entries.
+	release_all();
+}
+
+bool slot_states::has_free_entry() const noexcept
+{
+	return m_freeHead != 0 || m_usedCount < first_chunk_size * ((size_t(1) << m_chunkCount) - 1);
+}
+
+size_t slot_states::chunk_count() const noexcept
+{
+	return m_chunkCount;
+}
+
+slot_states::chunk_ptr slot_states::allocate_chunk(size_t chunkIndex)
+{
+	if (chunkIndex >= max_chunk_count)
+	{
+		throw std::bad_alloc();
+	}
+	const size_t size = first_chunk_size << chunkIndex;
+	chunk_ptr chunk(new std::atomic<uint64_t>[size]);
+	for (size_t i = 0; i < size; ++i)
+	{
+		chunk[i].store(0, std::memory_order_relaxed);
+	}
+	return chunk;
+}
+
+void slot_states::add_chunk(chunk_ptr chunk) noexcept
+{
+	m_chunks[m_chunkCount].store(chunk.release(), std::memory_order_release);
+	++m_chunkCount;
+}
+
+void slot_states::reserve_entry(std::unique_lock<spin_mutex>& signalLock, chunk_ptr& spareChunk)
+{
+	// As with slots storage, chunk allocated while mutex unlocked.
+	while (!has_free_entry())
+	{
+		const size_t chunkIndex = m_chunkCount;
+		signalLock.unlock();
+		spareChunk = allocate_chunk(chunkIndex);
+		signalLock.lock();
+		if (m_chunkCount == chunkIndex)
+		{
+			add_chunk(std::move(spareChunk));
+		}
+	}
+}
+
+uint32_t slot_states::acquire(uint64_t id) noexcept
+{
+	uint32_t index = 0;
+	if (m_freeHead != 0)
+	{
+		index = m_freeHead - 1;
+		m_freeHead = uint32_t(entry(index).load(std::memory_order_relaxed) & ~free_entry_bit);
+	}
+	else
+	{
+		index = m_usedCount++;
+	}
+	entry(index).store(id, std::memory_order_release);
+	return index;
+}
+
+void slot_states::release(slot_key key) noexcept
+{
+	if (key.index >= m_usedCount)
+	{
+		return;
+	}
+	auto& item = entry(key.index);
+	if (item.load(std::memory_order_relaxed) == key.id)
+	{
+		item.store(free_entry_bit | m_freeHead, std::memory_order_release);
+		m_freeHead = key.index + 1;
+	}
+}
+
+void slot_states::release_all() noexcept
+{
+	for (uint32_t index = 0; index < m_usedCount; ++index)
+	{
+		const uint32_t nextFree = (index + 1 < m_usedCount) ? index + 2 : 0;
+		entry(index).store(free_entry_bit | nextFree, std::memory_order_release);
+	}
+	m_freeHead = (m_usedCount != 0) ? 1 : 0;
+}
+
+} // namespace is::signals::detail
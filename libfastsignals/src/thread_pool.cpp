@@ -0,0 +1,241 @@
+#include "../include/thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace is::signals
+{
+
+namespace
+{
+// Allows worker thread to post tasks into its own queue.
+thread_local const thread_pool* t_currentPool = nullptr;
+thread_local std::size_t t_currentWorker = 0;
+
+// State of parallel_for call shared by its chunks.
+struct join_state
+{
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::atomic<std::size_t> remainingCount = 0;
+	std::exception_ptr error;
+};
+} // namespace
+
+thread_pool::thread_pool(std::size_t threadCount)
+{
+	threadCount = std::max(threadCount, std::size_t(1));
+	m_workers.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		m_workers.emplace_back(std::make_unique<worker>());
+	}
+
+	try
+	{
+		for (std::size_t i = 0; i < threadCount; ++i)
+		{
+			m_workers[i]->thread = std::thread([this, i] {
+				run_worker(i);
+			});
+		}
+	}
+	catch (...)
+	{
+		stop();
+		throw;
+	}
+}
+
+thread_pool::~thread_pool()
+{
+	stop();
+}
+
+void thread_pool::stop() noexcept
+{
+	{
+		std::lock_guard lock(m_sleepMutex);
+		m_stopped = true;
+	}
+	m_wakeup.notify_all();
+
+	for (auto& worker : m_workers)
+	{
+		if (worker->thread.joinable())
+		{
+			worker->thread.join();
+		}
+	}
+}
+
+std::size_t thread_pool::size() const noexcept
+{
+	return m_workers.size();
+}
+
+void thread_pool::post(function<void()> task)
+{
+	auto& worker = *m_workers[get_queue_index()];
+	{
+		std::lock_guard lock(worker.mutex);
+		worker.tasks.emplace_back(std::move(task));
+	}
+	m_taskCount.fetch_add(1, std::memory_order_release);
+
+	// Lock guarantees that worker either sees new task count or is already waiting for notification.
+	{
+		std::lock_guard lock(m_sleepMutex);
+	}
+	m_wakeup.notify_one();
+}
+
+void thread_pool::parallel_for(std::size_t count, std::size_t grainSize, const function<void(std::size_t, std::size_t)>& body)
+{
+	grainSize = std::max(grainSize, std::size_t(1));
+	const std::size_t chunkCount = (count + grainSize - 1) / grainSize;
+	if (chunkCount <= 1)
+	{
+		if (count != 0)
+		{
+			// function<> takes arguments by rvalue reference, so count is copied.
+			body(0, std::size_t(count));
+		}
+		return;
+	}
+
+	join_state state;
+	state.remainingCount = chunkCount;
+	auto runChunk = [&state, &body, count, grainSize](std::size_t chunk) {
+		std::exception_ptr error;
+		try
+		{
+			const std::size_t begin = chunk * grainSize;
+			const std::size_t end = std::min(begin + grainSize, count);
+			body(std::size_t(begin), std::size_t(end));
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		// Counter changed under lock, so state cannot be destroyed while last chunk notifies waiting thread.
+		std::lock_guard lock(state.mutex);
+		if (error && !state.error)
+		{
+			state.error = error;
+		}
+		if (state.remainingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			state.finished.notify_all();
+		}
+	};
+
+	// Queued chunks use state and body from this stack frame, so it's left only after all of them finished.
+	std::exception_ptr postError;
+	std::size_t chunk = 1;
+	try
+	{
+		for (; chunk < chunkCount; ++chunk)
+		{
+			post([&runChunk, chunk] {
+				runChunk(chunk);
+			});
+		}
+	}
+	catch (...)
+	{
+		postError = std::current_exception();
+	}
+	// Chunks which weren't queued run on calling thread.
+	for (; chunk < chunkCount; ++chunk)
+	{
+		runChunk(chunk);
+	}
+	runChunk(0);
+
+	// Help workers instead of sleeping, it also runs nested parallel_for chunks queued by this thread.
+	const std::size_t index = get_queue_index();
+	while (state.remainingCount.load(std::memory_order_acquire) != 0 && try_run_task(index))
+	{
+	}
+
+	std::unique_lock lock(state.mutex);
+	state.finished.wait(lock, [&state] {
+		return state.remainingCount.load(std::memory_order_acquire) == 0;
+	});
+	if (state.error)
+	{
+		std::rethrow_exception(state.error);
+	}
+	if (postError)
+	{
+		std::rethrow_exception(postError);
+	}
+}
+
+void thread_pool::run_worker(std::size_t index)
+{
+	t_currentPool = this;
+	t_currentWorker = index;
+
+	while (true)
+	{
+		if (try_run_task(index))
+		{
+			continue;
+		}
+
+		std::unique_lock lock(m_sleepMutex);
+		m_wakeup.wait(lock, [this] {
+			return m_stopped || m_taskCount.load(std::memory_order_acquire) != 0;
+		});
+		if (m_stopped && m_taskCount.load(std::memory_order_acquire) == 0)
+		{
+			return;
+		}
+	}
+}
+
+bool thread_pool::try_run_task(std::size_t index)
+{
+	// Worker takes the most recent task from its own queue and the oldest task from queues of other workers.
+	function<void()> task;
+	bool found = false;
+	for (std::size_t i = 0; i < m_workers.size() && !found; ++i)
+	{
+		auto& worker = *m_workers[(index + i) % m_workers.size()];
+		std::lock_guard lock(worker.mutex);
+		if (!worker.tasks.empty())
+		{
+			if (i == 0)
+			{
+				task = std::move(worker.tasks.back());
+				worker.tasks.pop_back();
+			}
+			else
+			{
+				task = std::move(worker.tasks.front());
+				worker.tasks.pop_front();
+			}
+			found = true;
+		}
+	}
+
+	if (found)
+	{
+		m_taskCount.fetch_sub(1, std::memory_order_relaxed);
+		task();
+	}
+	return found;
+}
+
+std::size_t thread_pool::get_queue_index() noexcept
+{
+	if (t_currentPool == this)
+	{
+		return t_currentWorker;
+	}
+	return m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+}
+
+} // namespace is::signals
@@ -0,0 +1,203 @@
+#include "../include/unordered_signal_impl.h"
+#include <algorithm>
+
+namespace is::signals::detail
+{
+namespace
+{
+// Grows vector geometrically, so the next push_back cannot throw.
+template <class T>
+void reserve_for_push_back(std::vector<T>& items)
+{
+	if (items.size() == items.capacity())
+	{
+		items.reserve(std::max(items.size() * 2, size_t(4)));
+	}
+}
+} // namespace
+
+unordered_signal_impl::unordered_signal_impl()
+	: m_states(std::make_shared<slot_states>(*this))
+{
+}
+
+unordered_signal_impl::~unordered_signal_impl()
+{
+	m_states->detach();
+}
+
+slot_key unordered_signal_impl::add(packed_function fn)
+{
+	slot_states::chunk_ptr spareChunk;
+	std::unique_lock lock(m_mutex);
+	m_states->reserve_entry(lock, spareChunk);
+
+	// Number of distinct callable types is small, so linear search is fast enough.
+	const void* typeKey = fn.type_key();
+	auto bucket = std::find_if(m_buckets.begin(), m_buckets.end(), [typeKey](const slot_bucket& bucket) {
+		return bucket.typeKey == typeKey;
+	});
+	if (bucket == m_buckets.end())
+	{
+		reserve_for_push_back(m_buckets);
+		bucket = m_buckets.insert(m_buckets.end(), slot_bucket{ typeKey, {}, {} });
+	}
+	reserve_for_push_back(bucket->functions);
+	reserve_for_push_back(bucket->stateIndexes);
+	// Released entries are reused first, so index of new entry never exceeds number of connected slots.
+	if (m_positions.size() <= m_count)
+	{
+		m_positions.resize(std::max(m_positions.size() * 2, size_t(16)));
+	}
+
+	const uint64_t id = m_nextId++;
+	const uint32_t index = m_states->acquire(id);
+	m_positions[index] = { uint32_t(std::distance(m_buckets.begin(), bucket)), uint32_t(bucket->functions.size()) };
+	bucket->functions.push_back(std::move(fn));
+	bucket->stateIndexes.push_back(index);
+	++m_count;
+	return { id, index };
+}
+
+void unordered_signal_impl::remove(slot_key key, packed_function& removedFunction, released_storage_ptr& /*releasedStorage*/) noexcept
+{
+	std::lock_guard lock(m_mutex);
+	remove_locked(key, removedFunction);
+}
+
+void unordered_signal_impl::remove(span<const slot_key> keys, std::vector<packed_function>& removedFunctions, released_storage_ptr& /*releasedStorage*/) noexcept
+{
+	std::lock_guard lock(m_mutex);
+	for (const slot_key& key : keys)
+	{
+		packed_function removedFunction;
+		remove_locked(key, removedFunction);
+		if (!removedFunction.empty())
+		{
+			removedFunctions.push_back(std::move(removedFunction));
+		}
+	}
+}
+
+void unordered_signal_impl::remove_locked(slot_key key, packed_function& removedFunction) noexcept
+{
+	if (!m_states->is_connected(key))
+	{
+		return;
+	}
+	const slot_position position = m_positions[key.index];
+	auto& bucket = m_buckets[position.bucket];
+	removedFunction = std::move(bucket.functions[position.index]);
+	m_states->release(key);
+	--m_count;
+	if (m_emissionCount != 0)
+	{
+		// Running emission keeps index of the next slot, so moved slot might be skipped.
+		bucket.stateIndexes[position.index] = removed_state_index;
+		++m_removedCount;
+		return;
+	}
+	erase_locked(position);
+}
+
+void unordered_signal_impl::erase_locked(slot_position position) noexcept
+{
+	auto& bucket = m_buckets[position.bucket];
+	const size_t last = bucket.functions.size() - 1;
+	if (position.index != last)
+	{
+		bucket.functions[position.index] = std::move(bucket.functions[last]);
+		bucket.stateIndexes[position.index] = bucket.stateIndexes[last];
+		if (bucket.stateIndexes[position.index] != removed_state_index)
+		{
+			m_positions[bucket.stateIndexes[position.index]] = position;
+		}
+	}
+	bucket.functions.pop_back();
+	bucket.stateIndexes.pop_back();
+}
+
+void unordered_signal_impl::compact_locked() noexcept
+{
+	for (uint32_t bucketIndex = 0; bucketIndex < m_buckets.size(); ++bucketIndex)
+	{
+		auto& stateIndexes = m_buckets[bucketIndex].stateIndexes;
+		for (uint32_t index = 0; index < stateIndexes.size();)
+		{
+			if (stateIndexes[index] == removed_state_index)
+			{
+				// Slot moved from the last place is checked on the next iteration.
+				erase_locked({ bucketIndex, index });
+			}
+			else
+			{
+				++index;
+			}
+		}
+	}
+	m_removedCount = 0;
+}
+
+void unordered_signal_impl::remove_all() noexcept
+{
+	std::vector<slot_bucket> buckets;
+	{
+		std::lock_guard lock(m_mutex);
+		buckets.swap(m_buckets);
+		m_count = 0;
+		m_removedCount = 0;
+		m_states->release_all();
+	}
+}
+
+size_t unordered_signal_impl::count() const noexcept
+{
+	std::lock_guard lock(m_mutex);
+	return m_count;
+}
+
+const slot_states_ptr& unordered_signal_impl::states() const noexcept
+{
+	return m_states;
+}
+
+bool unordered_signal_impl::get_next_slot(packed_function& slot, slot_cursor& cursor)
+{
+	// Previous slot may be the last owner of removed slot, so it's destroyed before mutex locked.
+	slot.reset();
+	std::lock_guard lock(m_mutex);
+
+	// Slots aren't moved during emission, so index stays valid between mutex locks.
+	for (; cursor.bucket < m_buckets.size(); ++cursor.bucket, cursor.index = 0)
+	{
+		const auto& functions = m_buckets[cursor.bucket].functions;
+		for (; cursor.index < functions.size(); ++cursor.index)
+		{
+			if (!functions[cursor.index].empty())
+			{
+				slot = functions[cursor.index];
+				++cursor.index;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+unordered_signal_impl::emission_guard::emission_guard(unordered_signal_impl& impl) noexcept
+	: m_impl(impl)
+{
+	std::lock_guard lock(m_impl.m_mutex);
+	++m_impl.m_emissionCount;
+}
+
+unordered_signal_impl::emission_guard::~emission_guard()
+{
+	std::lock_guard lock(m_impl.m_mutex);
+	if (--m_impl.m_emissionCount == 0 && m_impl.m_removedCount != 0)
+	{
+		m_impl.compact_locked();
+	}
+}
+
+} // namespace is::signals::detail
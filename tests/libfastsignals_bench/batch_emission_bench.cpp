@@ -0,0 +1,69 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <tuple>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 16;
+constexpr unsigned itemCount = 10'000;
+
+using row_changed_signal = signal<void(unsigned, double)>;
+
+// Emulates bulk import which emits signal for each changed row.
+std::vector<row_changed_signal::batch_item_type> make_rows()
+{
+	std::vector<row_changed_signal::batch_item_type> rows;
+	rows.reserve(itemCount);
+	for (unsigned i = 0; i < itemCount; ++i)
+	{
+		rows.emplace_back(i, i * 0.5);
+	}
+	return rows;
+}
+} // namespace
+
+TEST_CASE("Emit signal with 16 slots for 10k rows", "[batch_emission]")
+{
+	const auto rows = make_rows();
+	double checksum = 0;
+	row_changed_signal event;
+	for (unsigned i = 0; i < slotCount; ++i)
+	{
+		event.connect([i, &checksum](unsigned row, double value) {
+			checksum += row * i + value;
+		});
+	}
+
+	BENCHMARK("loop of emissions")
+	{
+		for (const auto& [row, value] : rows)
+		{
+			event(row, value);
+		}
+	}
+
+	BENCHMARK("batch emission")
+	{
+		event.emit_batch(rows);
+	}
+
+	row_changed_signal batchEvent;
+	for (unsigned i = 0; i < slotCount; ++i)
+	{
+		batchEvent.connect_batch([i, &checksum](span<const row_changed_signal::batch_item_type> items) {
+			for (const auto& [row, value] : items)
+			{
+				checksum += row * i + value;
+			}
+		});
+	}
+
+	BENCHMARK("batch emission with batch slots")
+	{
+		batchEvent.emit_batch(rows);
+	}
+	REQUIRE(checksum > 0);
+}
@@ -0,0 +1,51 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <array>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned signalCount = 10;
+constexpr unsigned slotsPerSignal = 2'000;
+
+// Each signal has foreign slots connected before and after slots of disconnected object.
+template <class Connect>
+void connect_object(std::array<signal<void(int)>, signalCount>& signals, std::vector<connection>& foreign, Connect&& connect)
+{
+	auto slot = [](int) {
+	};
+	for (auto& event : signals)
+	{
+		foreign.push_back(event.connect(slot));
+		for (unsigned i = 0; i < slotsPerSignal; ++i)
+		{
+			connect(event.connect(slot));
+		}
+		foreign.push_back(event.connect(slot));
+	}
+}
+} // namespace
+
+TEST_CASE("Disconnect object connected to many signals", "[connection_group]")
+{
+	std::array<signal<void(int)>, signalCount> signals;
+	std::vector<connection> foreign;
+
+	BENCHMARK("vector of scoped_connection")
+	{
+		std::vector<scoped_connection> connections;
+		connect_object(signals, foreign, [&](connection conn) {
+			connections.emplace_back(std::move(conn));
+		});
+	}
+
+	BENCHMARK("connection_group")
+	{
+		connection_group group;
+		connect_object(signals, foreign, [&](connection conn) {
+			group.add(std::move(conn));
+		});
+	}
+}
@@ -0,0 +1,59 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned connectionCount = 500;
+constexpr unsigned copyCount = 2'000;
+constexpr unsigned reconnectCount = 100'000;
+} // namespace
+
+TEST_CASE("Copy and disconnect connections", "[connection_handle]")
+{
+	signal<void(int)> event;
+	auto slot = [](int) {
+	};
+
+	std::vector<connection> connections;
+	std::vector<connection_handle> handles;
+	for (unsigned i = 0; i < connectionCount; ++i)
+	{
+		connections.push_back(event.connect(slot));
+		handles.push_back(event.connect(slot, handle_tag{}));
+	}
+
+	BENCHMARK("copy vector of 500 connection")
+	{
+		for (unsigned i = 0; i < copyCount; ++i)
+		{
+			std::vector<connection> copy(connections);
+		}
+	}
+
+	BENCHMARK("copy vector of 500 connection_handle")
+	{
+		for (unsigned i = 0; i < copyCount; ++i)
+		{
+			std::vector<connection_handle> copy(handles);
+		}
+	}
+
+	BENCHMARK("connect and disconnect connection")
+	{
+		for (unsigned i = 0; i < reconnectCount; ++i)
+		{
+			event.connect(slot).disconnect();
+		}
+	}
+
+	BENCHMARK("connect and disconnect connection_handle")
+	{
+		for (unsigned i = 0; i < reconnectCount; ++i)
+		{
+			event.connect(slot, handle_tag{}).disconnect();
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 2'000;
+constexpr unsigned emitCount = 1'000;
+
+struct Listener
+{
+	int total = 0;
+
+	void on_value(int value)
+	{
+		total += value;
+	}
+};
+} // namespace
+
+TEST_CASE("Emit signal with method slots", "[delegate]")
+{
+	std::vector<Listener> listeners(slotCount);
+	signal<void(int)> lambdas;
+	signal<void(int)> methods;
+	for (auto& listener : listeners)
+	{
+		lambdas.connect([&listener](int value) {
+			listener.on_value(value);
+		});
+		methods.connect(mem_fn_slot<&Listener::on_value>(&listener));
+	}
+
+	BENCHMARK("lambda")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			lambdas(int(i));
+		}
+	}
+
+	BENCHMARK("mem_fn_slot")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			methods(int(i));
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 20'000;
+
+struct Listener
+{
+	int total = 0;
+
+	void on_value(int value)
+	{
+		total += value;
+	}
+};
+} // namespace
+
+TEST_CASE("Disconnect method slots", "[disconnect_slot]")
+{
+	std::vector<Listener> listeners(slotCount);
+
+	BENCHMARK("disconnect connections")
+	{
+		signal<void(int)> event;
+		std::vector<connection> connections;
+		connections.reserve(slotCount);
+		for (auto& listener : listeners)
+		{
+			connections.push_back(event.connect(mem_fn_slot<&Listener::on_value>(&listener)));
+		}
+		// Slots are disconnected from the back, so storage compaction doesn't dominate.
+		for (auto it = connections.rbegin(); it != connections.rend(); ++it)
+		{
+			it->disconnect();
+		}
+	}
+
+	BENCHMARK("disconnect slots")
+	{
+		signal<void(int)> event;
+		for (auto& listener : listeners)
+		{
+			event.connect(mem_fn_slot<&Listener::on_value>(&listener));
+		}
+		for (auto it = listeners.rbegin(); it != listeners.rend(); ++it)
+		{
+			event.disconnect(mem_fn_slot<&Listener::on_value>(&*it));
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/event_queue.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned totalEventCount = 1'000'000;
+
+// Pushes events from given number of producers and calls them on this thread.
+void run_producers(event_queue& queue, unsigned producerCount)
+{
+	const unsigned eventCount = totalEventCount / producerCount;
+	unsigned sum = 0;
+	std::vector<std::thread> producers;
+	for (unsigned pi = 0; pi < producerCount; ++pi)
+	{
+		producers.emplace_back([&queue, &sum, eventCount] {
+			for (unsigned i = 0; i < eventCount; ++i)
+			{
+				while (!queue.try_push([&sum, i] {
+					sum += i;
+				}))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (unsigned received = 0; received < eventCount * producerCount;)
+	{
+		if (queue.try_call_one())
+		{
+			++received;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+}
+} // namespace
+
+TEST_CASE("Pass 1M events through event queue from 1 to 16 producers", "[event_queue]")
+{
+	for (unsigned producerCount : { 1, 2, 4, 8, 16 })
+	{
+		event_queue unboundedQueue;
+		BENCHMARK("unbounded queue, " + std::to_string(producerCount) + " producers")
+		{
+			run_producers(unboundedQueue, producerCount);
+		}
+
+		event_queue boundedQueue(1024);
+		BENCHMARK("bounded queue with 1024 events, " + std::to_string(producerCount) + " producers")
+		{
+			run_producers(boundedQueue, producerCount);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "perf_counter.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned emitCount = 1'000'000;
+
+#if defined(LIBFASTSIGNALS_CACHE_LINE_LAYOUT)
+constexpr const char* layout_name = "cache line layout";
+#else
+constexpr const char* layout_name = "packed layout";
+#endif
+
+unsigned get_background_thread_count()
+{
+	return std::max(1u, std::thread::hardware_concurrency() - 1);
+}
+
+// Emits frozen signal while background threads call set_shrink_policy() on signal returned by `target`.
+// These calls write signal mutex and connect data, but emission of frozen signal reads only
+//  emission data, so threads contend only if these fields share cache line, see LIBFASTSIGNALS_CACHE_LINE_LAYOUT.
+template <class Target>
+void run_emit_with_locked_changes(const char* name, Target&& target)
+{
+	signal<void(unsigned)> event;
+	std::atomic<unsigned> sum = 0;
+	event.connect([&sum](unsigned value) {
+		sum.fetch_add(value, std::memory_order_relaxed);
+	});
+	event.freeze();
+	signal<void(unsigned)> otherEvent;
+	auto& changedEvent = target(event, otherEvent);
+
+	std::atomic<bool> stopped = false;
+	std::atomic<unsigned> changeCount = 0;
+	std::vector<std::thread> threads;
+	for (unsigned i = 0, n = get_background_thread_count(); i < n; ++i)
+	{
+		threads.emplace_back([&] {
+			unsigned count = 0;
+			while (!stopped.load(std::memory_order_relaxed))
+			{
+				changedEvent.set_shrink_policy(shrink_policy::automatic);
+				++count;
+			}
+			changeCount += count;
+		});
+	}
+
+	perf_counter counter;
+	counter.start();
+	BENCHMARK(name)
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			event(i);
+		}
+	}
+	const auto events = counter.stop();
+
+	stopped = true;
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Benchmark is built with both layouts, see CMakeLists.txt, so reports of both builds can be compared.
+	std::cout << std::endl << name << " (" << layout_name << "): " << changeCount << " locked changes";
+	if (events)
+	{
+		std::cout << ", " << *events << " " << counter.event_name();
+	}
+	else
+	{
+		std::cout << ", perf counters not available";
+	}
+	std::cout << std::endl;
+}
+} // namespace
+
+TEST_CASE("Emit frozen signal while other threads change other signal", "[false_sharing]")
+{
+	run_emit_with_locked_changes("emit frozen 1M times, other signal changed", [](auto&, auto& otherEvent) -> auto& {
+		return otherEvent;
+	});
+}
+
+TEST_CASE("Emit frozen signal while other threads change it", "[false_sharing]")
+{
+	run_emit_with_locked_changes("emit frozen 1M times, same signal changed", [](auto& event, auto&) -> auto& {
+		return event;
+	});
+}
@@ -0,0 +1,59 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 256;
+constexpr unsigned slotWorkIterations = 20'000;
+
+// Emulates CPU-heavy independent slot, such as re-layout of one view.
+unsigned do_slot_work(unsigned seed)
+{
+	unsigned value = seed;
+	for (unsigned i = 0; i < slotWorkIterations; ++i)
+	{
+		value = value * 1664525u + 1013904223u;
+	}
+	return value;
+}
+
+void connect_heavy_slots(signal<void(unsigned)>& event, std::atomic<unsigned>& checksum)
+{
+	for (unsigned i = 0; i < slotCount; ++i)
+	{
+		event.connect([i, &checksum](unsigned value) {
+			checksum.fetch_add(do_slot_work(value + i), std::memory_order_relaxed);
+		});
+	}
+}
+} // namespace
+
+TEST_CASE("Emit signal with 256 CPU-heavy slots on thread pool", "[parallel_emission]")
+{
+	std::atomic<unsigned> checksum = 0;
+	signal<void(unsigned)> event;
+	connect_heavy_slots(event, checksum);
+
+	BENCHMARK("sequential emission")
+	{
+		event(1);
+	}
+
+	const unsigned maxThreadCount = std::max(2u, std::thread::hardware_concurrency());
+	for (unsigned threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		event.set_parallel_emission(std::make_shared<thread_pool>(threadCount), 4);
+		BENCHMARK("parallel emission, " + std::to_string(threadCount) + " threads")
+		{
+			event(1);
+		}
+	}
+	event.set_parallel_emission(nullptr);
+}
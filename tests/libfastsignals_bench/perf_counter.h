@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+
+#if defined(__linux__)
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	if defined(__x86_64__) || defined(__i386__)
+#		include <cpuid.h>
+#	endif
+#endif
+
+// Counts hardware event for calling thread and its children threads using Linux perf_event_open().
+// By default counts HITM events (loads which hit modified line in another core's cache) on Intel CPUs,
+//  using MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM (XSNP_FWD on newer CPUs), raw code 0x04d2.
+// On other CPUs, or if raw event isn't available, e.g. in virtual machine, it falls back to generic cache misses,
+//  which also count misses unrelated to false sharing. Set raw event code for your CPU in FASTSIGNALS_BENCH_PERF_EVENT
+//  variable to count other event. You can also run benchmark under `perf c2c record` to see contended cache lines.
+class perf_counter
+{
+public:
+	perf_counter()
+	{
+#if defined(__linux__)
+		if (const char* rawEvent = std::getenv("FASTSIGNALS_BENCH_PERF_EVENT"))
+		{
+			open(PERF_TYPE_RAW, std::strtoull(rawEvent, nullptr, 16));
+			m_eventName = "raw perf events";
+		}
+		else if (is_intel_cpu() && open(PERF_TYPE_RAW, intel_hitm_event))
+		{
+			m_eventName = "HITM events";
+		}
+		else if (open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES))
+		{
+			m_eventName = "cache misses (HITM not available)";
+		}
+#endif
+	}
+
+	perf_counter(const perf_counter&) = delete;
+	perf_counter& operator=(const perf_counter&) = delete;
+
+	~perf_counter()
+	{
+#if defined(__linux__)
+		if (m_fd >= 0)
+		{
+			close(m_fd);
+		}
+#endif
+	}
+
+	// Returns name of counted event for benchmark report.
+	const char* event_name() const noexcept
+	{
+		return m_eventName;
+	}
+
+	void start()
+	{
+#if defined(__linux__)
+		if (m_fd >= 0)
+		{
+			ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	// Returns number of events since start() or nullopt if counters aren't available.
+	std::optional<uint64_t> stop()
+	{
+#if defined(__linux__)
+		uint64_t value = 0;
+		if (m_fd >= 0)
+		{
+			ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+			if (read(m_fd, &value, sizeof(value)) == sizeof(value))
+			{
+				return value;
+			}
+		}
+#endif
+		return std::nullopt;
+	}
+
+private:
+#if defined(__linux__)
+	static constexpr uint64_t intel_hitm_event = 0x04d2;
+
+	static bool is_intel_cpu() noexcept
+	{
+#	if defined(__x86_64__) || defined(__i386__)
+		unsigned eax = 0;
+		unsigned ebx = 0;
+		unsigned ecx = 0;
+		unsigned edx = 0;
+		// Vendor string "GenuineIntel" is returned in ebx, edx, ecx.
+		return __get_cpuid(0, &eax, &ebx, &ecx, &edx) && ebx == 0x756e6547 && edx == 0x49656e69 && ecx == 0x6c65746e;
+#	else
+		return false;
+#	endif
+	}
+
+	bool open(uint32_t type, uint64_t config) noexcept
+	{
+		perf_event_attr attr = {};
+		attr.size = sizeof(attr);
+		attr.type = type;
+		attr.config = config;
+		attr.disabled = 1;
+		attr.inherit = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+		return m_fd >= 0;
+	}
+#endif
+
+	int m_fd = -1;
+	const char* m_eventName = "perf events";
+};
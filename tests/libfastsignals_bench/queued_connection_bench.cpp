@@ -0,0 +1,49 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <atomic>
+
+using namespace is::signals;
+
+namespace
+{
+// Emulates slow subscriber, such as metrics or logging.
+void do_slow_work(std::atomic<unsigned>& counter)
+{
+	for (unsigned i = 0; i < 10'000; ++i)
+	{
+		counter.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+} // namespace
+
+TEST_CASE("Emit signal with slow slot connected directly or via executor", "[queued_connection]")
+{
+	std::atomic<unsigned> counter = 0;
+	{
+		signal<void(int)> event;
+		event.connect([&counter](int) {
+			do_slow_work(counter);
+		});
+		BENCHMARK("direct connection")
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				event(i);
+			}
+		}
+	}
+	{
+		thread_executor executor;
+		signal<void(int)> event;
+		event.connect([&counter](int) {
+			do_slow_work(counter);
+		}, executor);
+		BENCHMARK("queued connection, emitting thread only")
+		{
+			for (int i = 0; i < 1000; ++i)
+			{
+				event(i);
+			}
+		}
+	}
+}
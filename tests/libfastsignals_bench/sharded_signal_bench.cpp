@@ -0,0 +1,81 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/sharded_signal.h"
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned initialSlotCount = 50'000;
+constexpr unsigned reconnectCountPerThread = 20'000;
+
+// Connects many slots, then each thread reconnects its own slots while one thread emits signal.
+template <class Signal>
+void run_reconnects(const std::string& name, unsigned threadCount)
+{
+	Signal event;
+	std::atomic<unsigned> sum = 0;
+	auto slot = [&sum](unsigned value) {
+		sum.fetch_add(value, std::memory_order_relaxed);
+	};
+	std::vector<connection> initialConnections;
+	initialConnections.reserve(initialSlotCount);
+	for (unsigned i = 0; i < initialSlotCount; ++i)
+	{
+		initialConnections.push_back(event.connect(slot));
+	}
+
+	std::atomic<bool> stopped = false;
+	std::thread emitter([&] {
+		while (!stopped.load(std::memory_order_relaxed))
+		{
+			event(1);
+		}
+	});
+
+	BENCHMARK(name)
+	{
+		std::vector<std::thread> threads;
+		for (unsigned ti = 0; ti < threadCount; ++ti)
+		{
+			threads.emplace_back([&] {
+				for (unsigned i = 0; i < reconnectCountPerThread; ++i)
+				{
+					event.connect(slot).disconnect();
+				}
+			});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	stopped = true;
+	emitter.join();
+}
+
+std::vector<unsigned> get_thread_counts()
+{
+	const unsigned maxThreadCount = std::max(2u, std::thread::hardware_concurrency());
+	std::vector<unsigned> result;
+	for (unsigned count = 1; count <= maxThreadCount; count *= 2)
+	{
+		result.push_back(count);
+	}
+	return result;
+}
+} // namespace
+
+TEST_CASE("Reconnect slots of signal with 50k slots while it is emitted", "[sharded_signal]")
+{
+	for (unsigned threadCount : get_thread_counts())
+	{
+		run_reconnects<signal<void(unsigned)>>("signal, " + std::to_string(threadCount) + " threads", threadCount);
+		run_reconnects<sharded_signal<void(unsigned)>>("sharded_signal, " + std::to_string(threadCount) + " threads", threadCount);
+	}
+}
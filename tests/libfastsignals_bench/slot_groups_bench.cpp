@@ -0,0 +1,73 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 20'000;
+constexpr unsigned emitCount = 1'000;
+} // namespace
+
+TEST_CASE("Connect slots with priorities", "[slot_groups]")
+{
+	auto slot = [](int) {
+	};
+
+	BENCHMARK("connect at back")
+	{
+		signal<void(int)> event;
+		for (unsigned i = 0; i < slotCount; ++i)
+		{
+			event.connect(slot);
+		}
+	}
+
+	BENCHMARK("connect at front")
+	{
+		signal<void(int)> event;
+		for (unsigned i = 0; i < slotCount; ++i)
+		{
+			event.connect(slot, connect_position::at_front);
+		}
+	}
+
+	BENCHMARK("connect to middle group")
+	{
+		signal<void(int)> event;
+		for (unsigned i = 0; i < slotCount; ++i)
+		{
+			event.connect(int(i % 3), slot, (i % 2 == 0) ? connect_position::at_back : connect_position::at_front);
+		}
+	}
+}
+
+TEST_CASE("Emit signal with slot groups", "[slot_groups]")
+{
+	auto slot = [](int) {
+	};
+	signal<void(int)> ungrouped;
+	signal<void(int)> grouped;
+	for (unsigned i = 0; i < slotCount / 10; ++i)
+	{
+		ungrouped.connect(slot);
+		grouped.connect(int(i % 4), slot, (i % 2 == 0) ? connect_position::at_back : connect_position::at_front);
+	}
+
+	BENCHMARK("ungrouped slots")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			ungrouped(int(i));
+		}
+	}
+
+	BENCHMARK("four groups")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			grouped(int(i));
+		}
+	}
+}
@@ -0,0 +1,69 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned signalCount = 2'000;
+constexpr unsigned slotsPerSignal = 250;
+
+using signal_type = signal<void(int)>;
+using slot_type = signal_type::slot_type;
+
+std::vector<slot_type> make_slots()
+{
+	std::vector<slot_type> slots;
+	for (unsigned i = 0; i < slotsPerSignal; ++i)
+	{
+		slots.emplace_back([i](int value) {
+			static_cast<void>(value + i);
+		});
+	}
+	return slots;
+}
+} // namespace
+
+// Builds graph of 500'000 connections, as application does on startup.
+TEST_CASE("Wire many signals at startup", "[startup]")
+{
+	const std::vector<slot_type> slots = make_slots();
+
+	BENCHMARK("connect() with connection")
+	{
+		std::vector<signal_type> signals(signalCount);
+		std::vector<connection> connections;
+		for (auto& event : signals)
+		{
+			for (const auto& slot : slots)
+			{
+				connections.push_back(event.connect(slot));
+			}
+		}
+	}
+
+	BENCHMARK("connect() with handle_tag")
+	{
+		std::vector<signal_type> signals(signalCount);
+		std::vector<connection_handle> handles;
+		for (auto& event : signals)
+		{
+			for (const auto& slot : slots)
+			{
+				handles.push_back(event.connect(slot, handle_tag{}));
+			}
+		}
+	}
+
+	BENCHMARK("connect_range()")
+	{
+		std::vector<signal_type> signals(signalCount);
+		std::vector<std::vector<connection_handle>> handles;
+		handles.reserve(signalCount);
+		for (auto& event : signals)
+		{
+			handles.push_back(event.connect_range(slots.begin(), slots.end()));
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/typed_signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 2'000;
+constexpr unsigned emitCount = 1'000;
+
+struct Listener
+{
+	int total = 0;
+
+	void on_value(int value)
+	{
+		total += value;
+	}
+};
+
+// Member function adaptor which typed signal keeps without type erasure.
+struct ListenerSlot
+{
+	Listener* listener = nullptr;
+
+	void operator()(int value) const
+	{
+		listener->on_value(value);
+	}
+};
+} // namespace
+
+TEST_CASE("Emit signal with slots of one type", "[typed_signal]")
+{
+	std::vector<Listener> listeners(slotCount);
+	signal<void(int)> erased;
+	typed_signal<void(int), ListenerSlot> typed;
+	for (auto& listener : listeners)
+	{
+		erased.connect(ListenerSlot{ &listener });
+		typed.connect(ListenerSlot{ &listener });
+	}
+
+	BENCHMARK("signal")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			erased(int(i));
+		}
+	}
+
+	BENCHMARK("typed_signal")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			typed(int(i));
+		}
+	}
+}
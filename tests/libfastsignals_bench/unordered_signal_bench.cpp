@@ -0,0 +1,94 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/unordered_signal.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+constexpr unsigned slotCount = 20'000;
+constexpr unsigned emitCount = 100;
+
+// Cache invalidation fan-out: slots of a few types connected in mixed order.
+template <class Signal>
+void connect_mixed_slots(Signal& event, std::vector<connection>& connections, int& counter)
+{
+	for (unsigned i = 0; i < slotCount; ++i)
+	{
+		switch (i % 3)
+		{
+		case 0:
+			connections.push_back(event.connect([&counter](int value) {
+				counter += value;
+			}));
+			break;
+		case 1:
+			connections.push_back(event.connect([&counter](int value) {
+				counter -= value;
+			}));
+			break;
+		default:
+			connections.push_back(event.connect([&counter](int value) {
+				counter ^= value;
+			}));
+			break;
+		}
+	}
+}
+
+template <class Signal>
+void disconnect_in_random_order()
+{
+	Signal event;
+	std::vector<connection> connections;
+	int counter = 0;
+	connect_mixed_slots(event, connections, counter);
+	std::shuffle(connections.begin(), connections.end(), std::mt19937(42));
+	for (auto& conn : connections)
+	{
+		conn.disconnect();
+	}
+}
+} // namespace
+
+TEST_CASE("Disconnect slots in random order", "[unordered_signal]")
+{
+	BENCHMARK("signal")
+	{
+		disconnect_in_random_order<signal<void(int)>>();
+	}
+
+	BENCHMARK("unordered_signal")
+	{
+		disconnect_in_random_order<unordered_signal<void(int)>>();
+	}
+}
+
+TEST_CASE("Emit signal with slots of mixed types", "[unordered_signal]")
+{
+	int counter = 0;
+	std::vector<connection> connections;
+	signal<void(int)> ordered;
+	unordered_signal<void(int)> unordered;
+	connect_mixed_slots(ordered, connections, counter);
+	connect_mixed_slots(unordered, connections, counter);
+
+	BENCHMARK("signal")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			ordered(int(i));
+		}
+	}
+
+	BENCHMARK("unordered_signal")
+	{
+		for (unsigned i = 0; i < emitCount; ++i)
+		{
+			unordered(int(i));
+		}
+	}
+}
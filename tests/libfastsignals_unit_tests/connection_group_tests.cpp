@@ -0,0 +1,128 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <memory>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Connection group disconnects all its slots in destructor", "[connection_group]")
+{
+	signal<void(int)> first;
+	signal<void(int)> second;
+	int sum = 0;
+	auto slot = [&sum](int value) {
+		sum += value;
+	};
+
+	connection kept = first.connect(slot);
+	{
+		connection_group group;
+		for (int i = 0; i < 10; ++i)
+		{
+			group.add(first.connect(slot));
+			group.add(second.connect(slot));
+		}
+		REQUIRE(group.size() == 20);
+		REQUIRE(first.num_slots() == 11);
+		first(1);
+		second(1);
+		REQUIRE(sum == 21);
+	}
+	REQUIRE(first.num_slots() == 1);
+	REQUIRE(second.num_slots() == 0);
+
+	sum = 0;
+	first(1);
+	second(1);
+	REQUIRE(sum == 1);
+}
+
+TEST_CASE("Connection group keeps order of remaining slots", "[connection_group]")
+{
+	signal<void()> event;
+	std::vector<int> calls;
+	connection_group group;
+	std::vector<connection> kept;
+	for (int i = 0; i < 8; ++i)
+	{
+		auto conn = event.connect([&calls, i] {
+			calls.push_back(i);
+		});
+		if (i % 2 == 0)
+		{
+			group.add(conn);
+		}
+		else
+		{
+			kept.push_back(conn);
+		}
+	}
+
+	group.disconnect();
+	REQUIRE(group.empty());
+	event();
+	REQUIRE(calls == std::vector<int>{ 1, 3, 5, 7 });
+}
+
+TEST_CASE("Connection group ignores destroyed signals and disconnected slots", "[connection_group]")
+{
+	auto dead = std::make_unique<signal<void()>>();
+	signal<void()> alive;
+	int callCount = 0;
+	auto slot = [&callCount] {
+		++callCount;
+	};
+
+	connection_group group;
+	group.add(dead->connect(slot));
+	auto conn = alive.connect(slot);
+	group.add(conn);
+	group.add(conn);
+	group.add(alive.connect(slot));
+	group.add(connection());
+	REQUIRE(group.size() == 4);
+
+	conn.disconnect();
+	dead.reset();
+	group.disconnect();
+	alive();
+	REQUIRE(callCount == 0);
+	REQUIRE(alive.num_slots() == 0);
+}
+
+TEST_CASE("Connection group can be moved", "[connection_group]")
+{
+	signal<void()> event;
+	connection_group group;
+	group.add(event.connect([] {
+	}));
+
+	connection_group other = std::move(group);
+	REQUIRE(group.empty());
+	REQUIRE(other.size() == 1);
+
+	connection_group third;
+	third.add(event.connect([] {
+	}));
+	third = std::move(other);
+	REQUIRE(event.num_slots() == 1);
+	third.disconnect();
+	REQUIRE(event.num_slots() == 0);
+}
+
+TEST_CASE("Slot destroyed by connection group can use its signal", "[connection_group]")
+{
+	signal<void()> event;
+	connection_group group;
+	auto guard = std::shared_ptr<int>(new int(0), [&event](int* value) {
+		delete value;
+		event.connect([] {
+		});
+	});
+	group.add(event.connect([guard] {
+	}));
+	guard.reset();
+
+	group.disconnect();
+	REQUIRE(event.num_slots() == 1);
+}
@@ -0,0 +1,231 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Can disconnect slot using copy of connection handle", "[connection_handle]")
+{
+	signal<void(int)> event;
+	int value = 0;
+	connection_handle handle = event.connect([&value](int newValue) {
+		value = newValue;
+	}, handle_tag{});
+	std::vector<connection_handle> handles(3, handle);
+	REQUIRE(handle.connected());
+
+	event(1);
+	REQUIRE(value == 1);
+
+	handles[1].disconnect();
+	REQUIRE(!handles[1].connected());
+	REQUIRE(!handle.connected());
+	REQUIRE(event.num_slots() == 0);
+	event(2);
+	REQUIRE(value == 1);
+
+	// Disconnecting stale copy does nothing.
+	handles[2].disconnect();
+	REQUIRE(!handles[2].connected());
+}
+
+TEST_CASE("Stale connection handle doesn't disconnect slot which reused its table entry", "[connection_handle]")
+{
+	signal<void()> event;
+	int callCount = 0;
+	auto slot = [&callCount] {
+		++callCount;
+	};
+
+	connection_handle first = event.connect(slot, handle_tag{});
+	connection_handle staleFirst = first;
+	first.disconnect();
+	connection_handle second = event.connect(slot, handle_tag{});
+	REQUIRE(staleFirst != second);
+
+	staleFirst.disconnect();
+	REQUIRE(second.connected());
+	event();
+	REQUIRE(callCount == 1);
+	second.disconnect();
+}
+
+TEST_CASE("Stale connection handles don't match entries connected after all handles disconnected", "[connection_handle]")
+{
+	constexpr int slotCount = 1000;
+	signal<void()> event;
+	int callCount = 0;
+	auto slot = [&callCount] {
+		++callCount;
+	};
+
+	std::vector<connection_handle> staleHandles;
+	for (int i = 0; i < slotCount; ++i)
+	{
+		staleHandles.push_back(event.connect(slot, handle_tag{}));
+	}
+	for (connection_handle handle : staleHandles)
+	{
+		handle.disconnect();
+	}
+
+	std::vector<connection_handle> handles;
+	for (int i = 0; i < slotCount; ++i)
+	{
+		handles.push_back(event.connect(slot, handle_tag{}));
+	}
+	for (connection_handle& handle : staleHandles)
+	{
+		REQUIRE(!handle.connected());
+		handle.disconnect();
+	}
+	event();
+	REQUIRE(callCount == slotCount);
+	for (connection_handle& handle : handles)
+	{
+		REQUIRE(handle.connected());
+		handle.disconnect();
+	}
+}
+
+TEST_CASE("Connection handle can be used after signal destroyed or cleared", "[connection_handle]")
+{
+	connection_handle handle;
+	REQUIRE(!handle.connected());
+	{
+		signal<void()> event;
+		handle = event.connect([] {
+		}, handle_tag{});
+		REQUIRE(handle.connected());
+	}
+	REQUIRE(!handle.connected());
+	handle.disconnect();
+
+	signal<void()> event;
+	handle = event.connect([] {
+	}, handle_tag{});
+	event.disconnect_all_slots();
+	REQUIRE(!handle.connected());
+	handle.disconnect();
+}
+
+TEST_CASE("Slot disconnected with connection handle can disconnect other handles in destructor", "[connection_handle]")
+{
+	signal<void()> event;
+	auto other = std::make_shared<connection_handle>(event.connect([] {
+	}, handle_tag{}));
+
+	struct disconnect_on_destroy
+	{
+		std::shared_ptr<connection_handle> handle;
+		~disconnect_on_destroy()
+		{
+			if (handle)
+			{
+				handle->disconnect();
+			}
+		}
+	};
+	auto guard = std::make_shared<disconnect_on_destroy>(disconnect_on_destroy{ other });
+	connection_handle handle = event.connect([guard] {
+	}, handle_tag{});
+	guard.reset();
+
+	handle.disconnect();
+	REQUIRE(!other->connected());
+	REQUIRE(event.num_slots() == 0);
+}
+
+TEST_CASE("Connection handles can be disconnected from a few threads while signal destroyed", "[connection_handle]")
+{
+	constexpr int slotCount = 1000;
+	auto event = std::make_unique<signal<void(int)>>();
+	std::atomic<int> sum = 0;
+	std::vector<connection_handle> handles;
+	for (int i = 0; i < slotCount; ++i)
+	{
+		handles.push_back(event->connect([&sum](int value) {
+			sum += value;
+		}, handle_tag{}));
+	}
+
+	std::thread first([&handles] {
+		for (int i = 0; i < slotCount; i += 2)
+		{
+			handles[i].disconnect();
+		}
+	});
+	std::thread second([&handles] {
+		for (int i = 1; i < slotCount; i += 2)
+		{
+			handles[i].disconnect();
+		}
+	});
+	(*event)(1);
+	event.reset();
+	first.join();
+	second.join();
+
+	REQUIRE(sum <= slotCount);
+	for (const auto& handle : handles)
+	{
+		REQUIRE(!handle.connected());
+	}
+}
+
+TEST_CASE("Can connect range of slots", "[connection_handle]")
+{
+	signal<void()> event;
+	std::vector<int> calls;
+	event.connect([&calls] {
+		calls.push_back(0);
+	});
+
+	std::vector<function<void()>> slots;
+	for (int i = 1; i <= 5; ++i)
+	{
+		slots.emplace_back([&calls, i] {
+			calls.push_back(i);
+		});
+	}
+	std::vector<connection_handle> handles = event.connect_range(slots.begin(), slots.end());
+	REQUIRE(handles.size() == 5);
+	REQUIRE(event.num_slots() == 6);
+	event();
+	REQUIRE(calls == std::vector<int>{ 0, 1, 2, 3, 4, 5 });
+
+	handles[1].disconnect();
+	handles[3].disconnect();
+	REQUIRE(handles[0].connected());
+	calls.clear();
+	event();
+	REQUIRE(calls == std::vector<int>{ 0, 1, 3, 5 });
+
+	event.disconnect_all_slots();
+	REQUIRE(!handles[0].connected());
+	REQUIRE(event.connect_range(slots.end(), slots.end()).empty());
+}
+
+TEST_CASE("Range isn't connected to frozen signal which throws on connect", "[connection_handle]")
+{
+	signal<void()> event;
+	event.freeze(freeze_policy::throw_on_connect);
+	std::vector<function<void()>> slots(3, [] {
+	});
+
+	REQUIRE_THROWS_AS(event.connect_range(slots.begin(), slots.end()), std::logic_error);
+	REQUIRE(event.num_slots() == 0);
+
+	// Table entries taken for failed connect are released and reused.
+	event.unfreeze();
+	auto handles = event.connect_range(slots.begin(), slots.end());
+	REQUIRE(handles.size() == 3);
+	for (auto handle : handles)
+	{
+		REQUIRE(handle.connected());
+	}
+}
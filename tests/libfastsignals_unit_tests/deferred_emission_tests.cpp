@@ -0,0 +1,175 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Deferred signal is emitted once with the last arguments on scope exit", "[deferred_emission]")
+{
+	signal<void(int)> valueChanged;
+	signal<void()> layoutChanged;
+	std::vector<int> values;
+	int layoutCount = 0;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+	layoutChanged.connect([&layoutCount] {
+		++layoutCount;
+	});
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(valueChanged);
+		for (int i = 1; i <= 100; ++i)
+		{
+			valueChanged(i);
+			layoutChanged();
+		}
+		REQUIRE(values.empty());
+		REQUIRE(layoutCount == 100);
+	}
+	REQUIRE(values == std::vector<int>{ 100 });
+
+	valueChanged(101);
+	REQUIRE(values == std::vector<int>{ 100, 101 });
+}
+
+TEST_CASE("Deferred signal can deliver all recorded emissions in order", "[deferred_emission]")
+{
+	signal<void(const std::string&)> rowAdded;
+	std::vector<std::string> rows;
+	rowAdded.connect([&rows](const std::string& row) {
+		rows.push_back(row);
+	});
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(rowAdded, deferral_policy::all);
+		rowAdded("first");
+		rowAdded("second");
+		REQUIRE(rows.empty());
+	}
+	REQUIRE(rows == std::vector<std::string>{ "first", "second" });
+}
+
+TEST_CASE("Deferred signal records each item of batch emission in order", "[deferred_emission]")
+{
+	signal<void(int)> valueChanged;
+	std::vector<int> values;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(valueChanged, deferral_policy::all);
+		valueChanged(1);
+		valueChanged.emit_batch(std::vector<std::tuple<int>>{ { 2 }, { 3 } });
+		REQUIRE(values.empty());
+	}
+	REQUIRE(values == std::vector<int>{ 1, 2, 3 });
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(valueChanged);
+		valueChanged.emit_batch(std::vector<std::tuple<int>>{ { 4 }, { 5 } });
+		REQUIRE(values.size() == 3);
+	}
+	REQUIRE(values == std::vector<int>{ 1, 2, 3, 5 });
+}
+
+TEST_CASE("Deferred signal can merge recorded emissions with reducer", "[deferred_emission]")
+{
+	signal<void(int, int)> rangeChanged;
+	std::vector<std::pair<int, int>> ranges;
+	rangeChanged.connect([&ranges](int first, int last) {
+		ranges.emplace_back(first, last);
+	});
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(rangeChanged, [](std::tuple<int, int>& merged, int first, int last) {
+			std::get<0>(merged) = std::min(std::get<0>(merged), first);
+			std::get<1>(merged) = std::max(std::get<1>(merged), last);
+		});
+		rangeChanged(10, 20);
+		rangeChanged(5, 7);
+		rangeChanged(15, 30);
+	}
+	REQUIRE(ranges == std::vector<std::pair<int, int>>{ { 5, 30 } });
+}
+
+TEST_CASE("Nested deferred scope delivers emissions to outer scope", "[deferred_emission]")
+{
+	signal<void(int)> valueChanged;
+	std::vector<int> values;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+
+	{
+		deferred_emission_scope outer;
+		outer.defer(valueChanged, deferral_policy::all);
+		valueChanged(1);
+		{
+			deferred_emission_scope inner;
+			inner.defer(valueChanged);
+			valueChanged(2);
+			valueChanged(3);
+		}
+		// Inner scope delivered the last emission, which was recorded by outer scope.
+		REQUIRE(values.empty());
+	}
+	REQUIRE(values == std::vector<int>{ 1, 3 });
+}
+
+TEST_CASE("Deferred scope doesn't affect emissions on other threads", "[deferred_emission]")
+{
+	signal<void(int)> valueChanged;
+	std::vector<int> values;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+
+	{
+		deferred_emission_scope scope;
+		scope.defer(valueChanged);
+		std::thread([&valueChanged] {
+			valueChanged(1);
+		}).join();
+		REQUIRE(values == std::vector<int>{ 1 });
+		valueChanged(2);
+		REQUIRE(values == std::vector<int>{ 1 });
+	}
+	REQUIRE(values == std::vector<int>{ 1, 2 });
+}
+
+TEST_CASE("Deferred scope discards emissions if it exits by exception", "[deferred_emission]")
+{
+	signal<void(int)> valueChanged;
+	std::vector<int> values;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+
+	try
+	{
+		deferred_emission_scope scope;
+		scope.defer(valueChanged);
+		valueChanged(1);
+		throw std::runtime_error("update failed");
+	}
+	catch (const std::runtime_error& /*e*/)
+	{
+	}
+	REQUIRE(values.empty());
+
+	valueChanged(2);
+	REQUIRE(values == std::vector<int>{ 2 });
+}
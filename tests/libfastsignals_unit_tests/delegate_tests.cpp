@@ -0,0 +1,151 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/delegate.h"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/unordered_signal.h"
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+class Recorder
+{
+public:
+	void on_value(int value)
+	{
+		m_values.push_back(value);
+	}
+
+	int scaled(int value) const
+	{
+		return value * m_scale;
+	}
+
+	void on_text(int value, const std::string& text)
+	{
+		m_texts.push_back(std::to_string(value) + text);
+	}
+
+	const std::vector<int>& values() const
+	{
+		return m_values;
+	}
+
+	const std::vector<std::string>& texts() const
+	{
+		return m_texts;
+	}
+
+private:
+	std::vector<int> m_values;
+	std::vector<std::string> m_texts;
+	int m_scale = 10;
+};
+} // namespace
+
+TEST_CASE("Delegate is two pointers and trivially copyable", "[delegate]")
+{
+	static_assert(std::is_trivially_copyable_v<delegate<void(int)>>);
+	static_assert(sizeof(delegate<void(int)>) == 2 * sizeof(void*));
+
+	Recorder recorder;
+	delegate<void(int)> onValue = mem_fn_slot<&Recorder::on_value>(&recorder);
+	const auto copy = onValue;
+	REQUIRE(copy);
+	REQUIRE(!delegate<void(int)>());
+
+	onValue(1);
+	copy(2);
+	REQUIRE(recorder.values() == std::vector<int>{ 1, 2 });
+}
+
+TEST_CASE("Signal calls method slots", "[delegate]")
+{
+	signal<void(int)> event;
+	Recorder first;
+	Recorder second;
+	event.connect(mem_fn_slot<&Recorder::on_value>(&first));
+	auto conn = event.connect(delegate<void(const int&)>(mem_fn_slot<&Recorder::on_value>(&second)));
+
+	event(1);
+	conn.disconnect();
+	event(2);
+	REQUIRE(first.values() == std::vector<int>{ 1, 2 });
+	REQUIRE(second.values() == std::vector<int>{ 1 });
+}
+
+TEST_CASE("Signal calls const method slot and combines results", "[delegate]")
+{
+	signal<int(int)> event;
+	const Recorder recorder;
+	event.connect(mem_fn_slot<&Recorder::scaled>(&recorder));
+	REQUIRE(event(4) == 40);
+
+	event.freeze();
+	REQUIRE(event(5) == 50);
+}
+
+TEST_CASE("Function keeps delegate when copied, moved and assigned", "[delegate]")
+{
+	Recorder recorder;
+	function<void(int)> onValue = mem_fn_slot<&Recorder::on_value>(&recorder);
+	function<void(int)> copy = onValue;
+	function<void(int)> moved = std::move(copy);
+	moved(1);
+	onValue(2);
+
+	// Buffer which kept lambda is reused for delegate and vice versa.
+	int lambdaCalls = 0;
+	function<void(int)> other = [&lambdaCalls](int) {
+		++lambdaCalls;
+	};
+	other = onValue;
+	other(3);
+	onValue = [&lambdaCalls](int) {
+		++lambdaCalls;
+	};
+	onValue(4);
+
+	REQUIRE(recorder.values() == std::vector<int>{ 1, 2, 3 });
+	REQUIRE(lambdaCalls == 1);
+}
+
+TEST_CASE("Packed delegate isn't unwrapped into proxy", "[delegate]")
+{
+	Recorder recorder;
+	function<void(int)> onValue = mem_fn_slot<&Recorder::on_value>(&recorder);
+	auto packed = onValue.release();
+	REQUIRE_THROWS_AS(packed.get<void(int)>(), std::bad_function_call);
+	packed.call<void(int)>(5);
+	REQUIRE(recorder.values() == std::vector<int>{ 5 });
+}
+
+TEST_CASE("Method slot receives batch emission item by item", "[delegate]")
+{
+	signal<void(int, const std::string&)> event;
+	Recorder recorder;
+	event.connect(mem_fn_slot<&Recorder::on_text>(&recorder));
+
+	const std::vector<std::tuple<int, std::string>> items = { { 1, "a" }, { 2, "b" } };
+	event.emit_batch(items);
+	REQUIRE(recorder.texts() == std::vector<std::string>{ "1a", "2b" });
+}
+
+TEST_CASE("Unordered signal groups method slots by method", "[delegate]")
+{
+	unordered_signal<void(int)> event;
+	Recorder first;
+	Recorder second;
+	event.connect(mem_fn_slot<&Recorder::on_value>(&first));
+	event.connect([](int) {
+	});
+	event.connect(mem_fn_slot<&Recorder::on_value>(&second));
+
+	event(7);
+	REQUIRE(first.values() == std::vector<int>{ 7 });
+	REQUIRE(second.values() == std::vector<int>{ 7 });
+	REQUIRE(event.num_slots() == 3);
+}
@@ -0,0 +1,108 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/event_loop.h"
+#include "libfastsignals/include/signal.h"
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#	include <poll.h>
+#	include <unistd.h>
+#endif
+
+using namespace is::signals;
+using namespace std::literals;
+
+TEST_CASE("Delivers emissions on event loop thread", "[event_loop]")
+{
+	event_loop loop;
+	signal<void(int)> event;
+	std::vector<int> values;
+	std::thread::id slotThreadId;
+	event.connect([&](int value) {
+		values.push_back(value);
+		slotThreadId = std::this_thread::get_id();
+		if (value == 3)
+		{
+			loop.stop();
+		}
+	}, loop);
+
+	std::thread emitter([&event] {
+		for (int i = 1; i <= 3; ++i)
+		{
+			event(i);
+		}
+	});
+	loop.run();
+	emitter.join();
+
+	REQUIRE(slotThreadId == std::this_thread::get_id());
+	REQUIRE(values == std::vector<int>{ 1, 2, 3 });
+}
+
+TEST_CASE("Runs tasks until timeout expires", "[event_loop]")
+{
+	event_loop loop;
+	int callCount = 0;
+	loop.post([&callCount] {
+		++callCount;
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	REQUIRE(loop.run_for(20ms) == 1);
+	REQUIRE(std::chrono::steady_clock::now() - start >= 20ms);
+	REQUIRE(callCount == 1);
+	REQUIRE(loop.poll() == 0);
+}
+
+TEST_CASE("Runs all tasks posted before event loop woke up at once", "[event_loop]")
+{
+	event_loop loop;
+	int callCount = 0;
+	for (int i = 0; i < 100; ++i)
+	{
+		loop.post([&callCount] {
+			++callCount;
+		});
+	}
+
+#if defined(__linux__)
+	// All tasks wrote into eventfd only once.
+	std::uint64_t wakeupCount = 0;
+	REQUIRE(::read(loop.fd(), &wakeupCount, sizeof(wakeupCount)) == sizeof(wakeupCount));
+	REQUIRE(wakeupCount == 1);
+	REQUIRE(loop.poll() == 100);
+#else
+	REQUIRE(loop.run_once() == 100);
+#endif
+	REQUIRE(callCount == 100);
+}
+
+TEST_CASE("Runs tasks posted after task threw exception", "[event_loop]")
+{
+	event_loop loop;
+	int callCount = 0;
+	loop.post([] {
+		throw std::runtime_error("task failed");
+	});
+	loop.post([&callCount] {
+		++callCount;
+	});
+	REQUIRE_THROWS_AS(loop.run_once(), std::runtime_error);
+	REQUIRE(callCount == 0);
+
+#if defined(__linux__)
+	// Event loop embedded into other loop is woken up for tasks left in queue.
+	pollfd pfd = { loop.fd(), POLLIN, 0 };
+	REQUIRE(::poll(&pfd, 1, 0) == 1);
+#endif
+
+	loop.post([&callCount] {
+		++callCount;
+	});
+	REQUIRE(loop.run_for(20ms) == 2);
+	REQUIRE(callCount == 2);
+}
@@ -0,0 +1,139 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/event_queue.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Calls events in push order", "[event_queue]")
+{
+	event_queue queue;
+	std::vector<int> values;
+	for (int i = 0; i < 1000; ++i)
+	{
+		REQUIRE(queue.try_push([i, &values] {
+			values.push_back(i);
+		}));
+	}
+	while (queue.try_call_one())
+	{
+	}
+
+	REQUIRE(values.size() == 1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		REQUIRE(values[i] == i);
+	}
+}
+
+TEST_CASE("Bounded queue rejects events when full", "[event_queue]")
+{
+	event_queue queue(2);
+	REQUIRE(queue.is_bounded());
+	int callCount = 0;
+	auto increment = [&callCount] {
+		++callCount;
+	};
+
+	REQUIRE(queue.try_push(increment));
+	REQUIRE(queue.try_push(increment));
+	REQUIRE_FALSE(queue.try_push(increment));
+
+	REQUIRE(queue.try_call_one());
+	REQUIRE(queue.try_push(increment));
+	REQUIRE_FALSE(queue.try_push(increment));
+
+	while (queue.try_call_one())
+	{
+	}
+	REQUIRE(callCount == 3);
+}
+
+TEST_CASE("Accepts move-only events and destroys events which weren't called", "[event_queue]")
+{
+	auto value = std::make_shared<int>(42);
+	int result = 0;
+	{
+		event_queue queue;
+		REQUIRE(queue.try_push([ptr = std::make_unique<int>(1), &result] {
+			result = *ptr;
+		}));
+		REQUIRE(queue.try_push([value] {
+		}));
+		REQUIRE(value.use_count() == 2);
+		REQUIRE(queue.try_call_one());
+	}
+	REQUIRE(result == 1);
+	REQUIRE(value.use_count() == 1);
+}
+
+TEST_CASE("Reuses event storage after event throws", "[event_queue]")
+{
+	event_queue queue(1);
+	REQUIRE(queue.try_push([] {
+		throw std::runtime_error("event failed");
+	}));
+	REQUIRE_THROWS_AS(queue.try_call_one(), std::runtime_error);
+
+	bool called = false;
+	REQUIRE(queue.try_push([&called] {
+		called = true;
+	}));
+	REQUIRE(queue.try_call_one());
+	REQUIRE(called);
+}
+
+TEST_CASE("Receives all events from a few producers", "[event_queue]")
+{
+	constexpr int producerCount = 4;
+	constexpr int eventCount = 20'000;
+	event_queue queue(64);
+	std::vector<int> lastValues(producerCount, -1);
+	std::atomic<bool> ordered = true;
+
+	std::vector<std::thread> producers;
+	for (int pi = 0; pi < producerCount; ++pi)
+	{
+		producers.emplace_back([&, pi] {
+			for (int i = 0; i < eventCount; ++i)
+			{
+				while (!queue.try_push([&, pi, i] {
+					if (lastValues[pi] + 1 != i)
+					{
+						ordered = false;
+					}
+					lastValues[pi] = i;
+				}))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	int received = 0;
+	while (received < producerCount * eventCount)
+	{
+		if (queue.try_call_one())
+		{
+			++received;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+	for (auto& producer : producers)
+	{
+		producer.join();
+	}
+
+	REQUIRE(ordered);
+	for (int value : lastValues)
+	{
+		REQUIRE(value == eventCount - 1);
+	}
+}
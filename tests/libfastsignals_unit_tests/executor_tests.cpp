@@ -0,0 +1,89 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/executor.h"
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+// Waits until executor runs all tasks posted by this thread.
+void wait_for_tasks(executor& executor)
+{
+	std::promise<void> done;
+	executor.post([&done] {
+		done.set_value();
+	});
+	done.get_future().wait();
+}
+} // namespace
+
+TEST_CASE("Runs posted tasks on executor thread in posting order", "[executor]")
+{
+	thread_executor executor;
+	std::vector<int> values;
+	std::thread::id executorThreadId;
+	for (int i = 0; i < 1000; ++i)
+	{
+		executor.post([i, &values, &executorThreadId] {
+			values.push_back(i);
+			executorThreadId = std::this_thread::get_id();
+		});
+	}
+	wait_for_tasks(executor);
+
+	REQUIRE(executorThreadId != std::this_thread::get_id());
+	REQUIRE(values.size() == 1000);
+	for (int i = 0; i < 1000; ++i)
+	{
+		REQUIRE(values[i] == i);
+	}
+}
+
+TEST_CASE("Keeps order of tasks posted by each of a few threads", "[executor]")
+{
+	constexpr int threadCount = 4;
+	constexpr int taskCount = 10'000;
+	std::vector<std::vector<int>> values(threadCount);
+	{
+		thread_executor executor;
+		std::vector<std::thread> threads;
+		for (int ti = 0; ti < threadCount; ++ti)
+		{
+			threads.emplace_back([ti, &executor, &values] {
+				for (int i = 0; i < taskCount; ++i)
+				{
+					executor.post([ti, i, &values] {
+						values[ti].push_back(i);
+					});
+				}
+			});
+		}
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	for (const auto& threadValues : values)
+	{
+		REQUIRE(threadValues.size() == taskCount);
+		for (int i = 0; i < taskCount; ++i)
+		{
+			REQUIRE(threadValues[i] == i);
+		}
+	}
+}
+
+TEST_CASE("Tasks can post new tasks", "[executor]")
+{
+	thread_executor executor;
+	std::promise<int> result;
+	executor.post([&] {
+		executor.post([&] {
+			result.set_value(42);
+		});
+	});
+	REQUIRE(result.get_future().get() == 42);
+}
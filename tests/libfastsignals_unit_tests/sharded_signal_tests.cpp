@@ -0,0 +1,90 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/sharded_signal.h"
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Sharded signal calls slots in connection order", "[sharded_signal]")
+{
+	sharded_signal<void(int)> event;
+	std::mutex valuesMutex;
+	std::vector<int> values;
+
+	// Connect from different threads, so slots get into different shards.
+	for (int i = 0; i < 16; ++i)
+	{
+		std::thread([&, i] {
+			event.connect([&, i](int value) {
+				values.push_back(i * value);
+			});
+		}).join();
+	}
+	REQUIRE(event.num_slots() == 16);
+
+	event(2);
+	REQUIRE(values.size() == 16);
+	for (int i = 0; i < 16; ++i)
+	{
+		REQUIRE(values[i] == i * 2);
+	}
+}
+
+TEST_CASE("Sharded signal can disconnect slots", "[sharded_signal]")
+{
+	sharded_signal<int(int)> event;
+	std::vector<connection> connections;
+	for (int i = 0; i < 8; ++i)
+	{
+		std::thread([&, i] {
+			connections.push_back(event.connect([i](int value) {
+				return i + value;
+			}));
+		}).join();
+	}
+	REQUIRE(event(100) == 107);
+
+	connections.back().disconnect();
+	REQUIRE(event.num_slots() == 7);
+	REQUIRE(event(100) == 106);
+
+	event.disconnect_all_slots();
+	REQUIRE(event.empty());
+	REQUIRE(!event(100));
+}
+
+TEST_CASE("Sharded signal slot can disconnect slot from other shard", "[sharded_signal]")
+{
+	sharded_signal<void()> event;
+	std::vector<int> calls;
+	connection second;
+	event.connect([&] {
+		calls.push_back(1);
+		second.disconnect();
+	});
+	std::thread([&] {
+		second = event.connect([&] {
+			calls.push_back(2);
+		});
+	}).join();
+	event.connect([&] {
+		calls.push_back(3);
+	});
+
+	event();
+	REQUIRE(calls == std::vector{ 1, 3 });
+}
+
+TEST_CASE("Sharded signal can be used as slot", "[sharded_signal]")
+{
+	sharded_signal<void(int)> source;
+	signal<void(int)> target;
+	int result = 0;
+	target.connect([&](int value) {
+		result = value;
+	});
+	source.connect(target);
+	source(42);
+	REQUIRE(result == 42);
+}
@@ -0,0 +1,231 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/thread_pool.h"
+
+// Coroutine tests are compiled only in C++20 mode.
+#if defined(LIBFASTSIGNALS_HAS_COROUTINES)
+#	include <atomic>
+#	include <coroutine>
+#	include <exception>
+#	include <memory>
+#	include <string>
+#	include <tuple>
+#	include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+// Coroutine which starts immediately and isn't awaited by anyone.
+struct fire_and_forget
+{
+	struct promise_type
+	{
+		fire_and_forget get_return_object() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_never final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			std::terminate();
+		}
+	};
+};
+
+// Coroutine which starts immediately and is destroyed by owner of returned object.
+struct owned_coroutine
+{
+	struct promise_type
+	{
+		owned_coroutine get_return_object() noexcept
+		{
+			return { std::coroutine_handle<promise_type>::from_promise(*this) };
+		}
+
+		std::suspend_never initial_suspend() noexcept
+		{
+			return {};
+		}
+
+		std::suspend_always final_suspend() noexcept
+		{
+			return {};
+		}
+
+		void return_void() noexcept
+		{
+		}
+
+		void unhandled_exception() noexcept
+		{
+			std::terminate();
+		}
+	};
+
+	std::coroutine_handle<promise_type> handle;
+};
+
+class manual_executor : public executor
+{
+public:
+	using executor::run_queued_tasks;
+
+protected:
+	void wakeup() noexcept override
+	{
+	}
+};
+} // namespace
+
+TEST_CASE("Coroutine can await next emission", "[signal_coroutines]")
+{
+	signal<void(int, const std::string&)> event;
+	std::vector<std::string> values;
+	auto coroutine = [&]() -> fire_and_forget {
+		auto [number, text] = co_await event.next();
+		values.push_back(std::to_string(number) + text);
+		const auto next = co_await event.next();
+		values.push_back(std::to_string(std::get<0>(next)) + std::get<1>(next));
+	};
+	coroutine();
+
+	REQUIRE(event.num_slots() == 1);
+	REQUIRE(values.empty());
+	event(1, "a");
+	REQUIRE(values == std::vector<std::string>{ "1a" });
+	event(2, "b");
+	REQUIRE(values == std::vector<std::string>{ "1a", "2b" });
+	REQUIRE(event.num_slots() == 0);
+	event(3, "c");
+	REQUIRE(values.size() == 2);
+}
+
+TEST_CASE("Coroutine can await signal with single argument or without arguments on executor", "[signal_coroutines]")
+{
+	manual_executor executor;
+	signal<void()> started;
+	signal<void(int)> valueChanged;
+	int result = 0;
+	auto coroutine = [&]() -> fire_and_forget {
+		co_await started.next(executor);
+		result = co_await valueChanged.next(executor);
+	};
+	coroutine();
+
+	started();
+	REQUIRE(valueChanged.num_slots() == 0);
+	REQUIRE(executor.run_queued_tasks() == 1);
+	valueChanged(42);
+	REQUIRE(result == 0);
+	REQUIRE(executor.run_queued_tasks() == 1);
+	REQUIRE(result == 42);
+}
+
+TEST_CASE("Coroutine awaits the next emission after slots which resumed it", "[signal_coroutines]")
+{
+	signal<void(int)> event;
+	std::vector<int> values;
+	event.connect([&values](int value) {
+		values.push_back(-value);
+	});
+	auto coroutine = [&]() -> fire_and_forget {
+		while (true)
+		{
+			const int value = co_await event.next();
+			values.push_back(value);
+			if (value == 2)
+			{
+				break;
+			}
+		}
+	};
+	coroutine();
+
+	event(1);
+	REQUIRE(values == std::vector<int>{ 1, -1 });
+	event(2);
+	REQUIRE(values == std::vector<int>{ 1, -1, 2, -2 });
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Coroutine destroyed while awaiting isn't resumed", "[signal_coroutines]")
+{
+	signal<void(int)> event;
+	int result = 0;
+	auto coroutine = [&]() -> owned_coroutine {
+		result = co_await event.next();
+	};
+	const owned_coroutine owner = coroutine();
+	REQUIRE(event.num_slots() == 1);
+
+	owner.handle.destroy();
+	REQUIRE(event.num_slots() == 0);
+	event(42);
+	REQUIRE(result == 0);
+}
+
+TEST_CASE("Coroutine can await signal with parallel emission", "[signal_coroutines]")
+{
+	signal<void(int)> event;
+	event.set_parallel_emission(std::make_shared<thread_pool>(2));
+	std::atomic<int> result = 0;
+	auto coroutine = [&]() -> fire_and_forget {
+		result = co_await event.next();
+	};
+	coroutine();
+
+	event(42);
+	REQUIRE(result == 42);
+	REQUIRE(event.num_slots() == 0);
+	event(1);
+	REQUIRE(result == 42);
+}
+
+TEST_CASE("Emission stream yields buffered emissions", "[signal_coroutines]")
+{
+	signal<void(int)> event;
+	auto stream = event.stream(2);
+	std::vector<int> values;
+	bool finished = false;
+	auto coroutine = [&]() -> fire_and_forget {
+		while (true)
+		{
+			const int value = co_await stream.next();
+			if (value < 0)
+			{
+				break;
+			}
+			values.push_back(value);
+		}
+		finished = true;
+	};
+
+	event(1);
+	event(2);
+	event(3);
+	REQUIRE(stream.dropped_count() == 1);
+
+	coroutine();
+	REQUIRE(values == std::vector<int>{ 2, 3 });
+	event(4);
+	REQUIRE(values == std::vector<int>{ 2, 3, 4 });
+	event(-1);
+	REQUIRE(finished);
+}
+
+#endif
@@ -1,6 +1,17 @@
 #include "catch2/catch.hpp"
 #include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
 
 using namespace is::signals;
 using namespace std::literals;
@@ -29,6 +40,27 @@ public:
 private:
 	result_type m_result = {};
 };
+
+template <class T>
+class vector_combiner
+{
+public:
+	using result_type = std::vector<T>;
+
+	template <class TRef>
+	void operator()(TRef&& value)
+	{
+		m_result.push_back(std::forward<TRef>(value));
+	}
+
+	result_type get_value() const
+	{
+		return m_result;
+	}
+
+private:
+	result_type m_result;
+};
 } // namespace
 
 TEST_CASE("Can connect a few slots and emit", "[signal]")
@@ -230,6 +262,31 @@ TEST_CASE("Can disconnect inside slot", "[signal]")
 	REQUIRE(value3 == 101);
 }
 
+TEST_CASE("Slot connected inside slot is called by the same emission", "[signal]")
+{
+	signal<void(int)> valueChanged;
+
+	std::vector<int> values;
+	bool connected = false;
+	valueChanged.connect([&](int value) {
+		values.push_back(value);
+		if (!connected)
+		{
+			connected = true;
+			valueChanged.connect([&values](int value) {
+				values.push_back(-value);
+			});
+		}
+	});
+
+	valueChanged(1);
+	REQUIRE(values == std::vector<int>{ 1, -1 });
+
+	values.clear();
+	valueChanged(2);
+	REQUIRE(values == std::vector<int>{ 2, -2 });
+}
+
 TEST_CASE("Disconnects OK if signal dead first", "[signal]")
 {
 	connection conn2;
@@ -245,15 +302,72 @@ TEST_CASE("Disconnects OK if signal dead first", "[signal]")
 			conn1 = valueChanged.connect([](int) {
 			});
 		}
-		REQUIRE(conn2.connected());
-		REQUIRE(conn1.connected());
+		// Connections know that signal was destroyed.
+		REQUIRE(!conn2.connected());
+		REQUIRE(!conn1.connected());
 		conn2.disconnect();
 		REQUIRE(!conn2.connected());
-		REQUIRE(conn1.connected());
+		REQUIRE(!conn1.connected());
 	}
 	conn2.disconnect();
 }
 
+TEST_CASE("Connection knows when slot disconnected by other copy or by signal", "[signal]")
+{
+	signal<void()> event;
+	auto slot = [] {
+	};
+
+	connection first = event.connect(slot);
+	connection copy = first;
+	copy.disconnect();
+	REQUIRE(!first.connected());
+
+	// New slot can reuse state of disconnected one, stale connection still knows it's disconnected.
+	connection second = event.connect(slot);
+	REQUIRE(second.connected());
+	REQUIRE(!first.connected());
+	first.disconnect();
+	REQUIRE(second.connected());
+	REQUIRE(event.num_slots() == 1);
+
+	event.disconnect_all_slots();
+	REQUIRE(!second.connected());
+	connection third = event.connect(slot);
+	REQUIRE(third.connected());
+	REQUIRE(!second.connected());
+}
+
+TEST_CASE("Connection can be checked while signal destroyed on other thread", "[signal]")
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		auto event = std::make_unique<signal<void()>>();
+		std::vector<connection> connections;
+		for (int j = 0; j < 20; ++j)
+		{
+			connections.push_back(event->connect([] {
+			}));
+		}
+
+		std::thread destroyer([&event] {
+			event.reset();
+		});
+		for (auto& conn : connections)
+		{
+			if (conn.connected())
+			{
+				conn.disconnect();
+			}
+		}
+		destroyer.join();
+		for (const auto& conn : connections)
+		{
+			REQUIRE(!conn.connected());
+		}
+	}
+}
+
 TEST_CASE("Returns last called slot result with default combiner", "[signal]")
 {
 	connection conn2;
@@ -273,8 +387,9 @@ TEST_CASE("Returns last called slot result with default combiner", "[signal]")
 			REQUIRE(absSignal(-1) == 1);
 			REQUIRE(absSignal(-177) == 177);
 			REQUIRE(absSignal(0) == 0);
+			REQUIRE(conn2.connected());
 		}
-		REQUIRE(conn2.connected());
+		REQUIRE(!conn2.connected());
 		conn2.disconnect();
 		REQUIRE(!conn2.connected());
 	}
@@ -659,6 +774,22 @@ TEST_CASE("Signal can be destroyed inside its slot and will call the rest of its
 	CHECK(called);
 }
 
+TEST_CASE("Signal can be destroyed inside its slot during emit_batch and will call the rest of its slots", "[signal]")
+{
+	std::optional<signal<void(int)>> s;
+	s.emplace();
+	s->connect([&](int) {
+		s.reset();
+	});
+	std::vector<int> values;
+	s->connect([&](int value) {
+		values.push_back(value);
+	});
+	const std::vector<std::tuple<int>> items = { { 1 }, { 2 } };
+	s->emit_batch(items);
+	CHECK(values == std::vector<int>{ 1, 2 });
+}
+
 TEST_CASE("Signal can be used as a slot for another signal", "[signal]")
 {
 	signal<void()> s1;
@@ -704,4 +835,1135 @@ TEST_CASE("Releases lambda and its captured const data", "[signal]")
 	}
 
 	CHECK(released);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Frozen signal calls all slots in connection order", "[signal]")
+{
+	signal<void(int)> valueChanged;
+	std::vector<int> values;
+	valueChanged.connect([&values](int value) {
+		values.push_back(value);
+	});
+	valueChanged.connect([&values](int value) {
+		values.push_back(value * 10);
+	});
+
+	valueChanged.freeze();
+	REQUIRE(valueChanged.is_frozen());
+	valueChanged(3);
+	REQUIRE(values == std::vector{ 3, 30 });
+	REQUIRE(valueChanged.num_slots() == 2);
+}
+
+TEST_CASE("Frozen signal unfreezes on connect and disconnect by default", "[signal]")
+{
+	signal<int(int)> absSignal;
+	auto conn = absSignal.connect([](int value) {
+		return value * value;
+	});
+	absSignal.freeze();
+	REQUIRE(absSignal(-3) == 9);
+
+	absSignal.connect([](int value) {
+		return abs(value);
+	});
+	REQUIRE(!absSignal.is_frozen());
+	REQUIRE(absSignal(-3) == 3);
+
+	absSignal.freeze();
+	conn.disconnect();
+	REQUIRE(!absSignal.is_frozen());
+	REQUIRE(absSignal.num_slots() == 1);
+	REQUIRE(absSignal(-5) == 5);
+}
+
+TEST_CASE("Frozen signal can forbid new connections", "[signal]")
+{
+	signal<void()> event;
+	int callCount = 0;
+	event.connect([&callCount] {
+		++callCount;
+	});
+	event.freeze(freeze_policy::throw_on_connect);
+
+	REQUIRE_THROWS_AS(event.connect([] {}), std::logic_error);
+	REQUIRE(event.is_frozen());
+	event();
+	REQUIRE(callCount == 1);
+
+	event.unfreeze();
+	event.connect([&callCount] {
+		++callCount;
+	});
+	event();
+	REQUIRE(callCount == 3);
+}
+
+TEST_CASE("Frozen signal can disconnect slot inside emission", "[signal]")
+{
+	signal<void()> event;
+	int callCount = 0;
+	connection conn;
+	conn = event.connect([&] {
+		++callCount;
+		conn.disconnect();
+	});
+	event.freeze();
+	event();
+	event();
+	REQUIRE(callCount == 1);
+	REQUIRE(!event.is_frozen());
+}
+
+TEST_CASE("Frozen signal releases snapshot after unfreeze", "[signal]")
+{
+	signal<void()> event;
+	const auto captured = std::make_shared<int>(0);
+	auto conn = event.connect([captured] {});
+
+	for (int i = 0; i < 3; ++i)
+	{
+		event.freeze();
+		event();
+		event.unfreeze();
+	}
+	REQUIRE(captured.use_count() == 2);
+
+	event.freeze();
+	conn.disconnect();
+	REQUIRE(captured.use_count() == 1);
+}
+
+TEST_CASE("Frozen signal keeps snapshot while emission iterates it", "[signal]")
+{
+	signal<void()> event;
+	const auto captured = std::make_shared<int>(0);
+	connection conn;
+	long useCountInSlot = 0;
+	event.connect([&] {
+		conn.disconnect();
+		useCountInSlot = captured.use_count();
+	});
+	conn = event.connect([captured] {});
+	event.freeze();
+	event();
+
+	// Slot stays in snapshot until emission finished.
+	REQUIRE(useCountInSlot == 2);
+	REQUIRE(captured.use_count() == 1);
+}
+
+TEST_CASE("Slot copied into frozen snapshot can disconnect other slot in destructor", "[signal]")
+{
+	// Each copy disconnects other slot on destruction, including copy kept by retired snapshot.
+	struct disconnector
+	{
+		disconnector(std::shared_ptr<connection> other)
+			: other(std::move(other))
+		{
+		}
+		disconnector(const disconnector&) = default;
+		disconnector(disconnector&&) = default;
+		~disconnector()
+		{
+			if (other)
+			{
+				other->disconnect();
+			}
+		}
+		void operator()() const
+		{
+		}
+
+		std::shared_ptr<connection> other;
+	};
+
+	signal<void()> event;
+	const auto other = std::make_shared<connection>(event.connect([] {}));
+	auto conn = event.connect(disconnector(other));
+	event.freeze();
+	event();
+
+	conn.disconnect();
+	REQUIRE(!other->connected());
+	REQUIRE(!event.is_frozen());
+}
+
+TEST_CASE("Can reserve and shrink slots storage", "[signal]")
+{
+	signal<void()> event;
+	event.reserve(100);
+	REQUIRE(event.capacity() >= 100);
+
+	int callCount = 0;
+	std::vector<connection> connections;
+	for (int i = 0; i < 100; ++i)
+	{
+		connections.push_back(event.connect([&callCount] {
+			++callCount;
+		}));
+	}
+	REQUIRE(event.capacity() >= 100);
+
+	// Reserved capacity kept even after mass disconnect.
+	for (size_t i = 1; i < connections.size(); ++i)
+	{
+		connections[i].disconnect();
+	}
+	REQUIRE(event.capacity() >= 100);
+
+	event.shrink_to_fit();
+	REQUIRE(event.num_slots() == 1);
+	REQUIRE(event.capacity() == 1);
+	event();
+	REQUIRE(callCount == 1);
+}
+
+TEST_CASE("Slots storage automatically shrinks after mass disconnect", "[signal]")
+{
+	signal<void(int)> event;
+	std::vector<connection> connections;
+	int sum = 0;
+	for (int i = 0; i < 1000; ++i)
+	{
+		connections.push_back(event.connect([&sum](int value) {
+			sum += value;
+		}));
+	}
+	REQUIRE(event.capacity() >= 1000);
+
+	for (size_t i = 10; i < connections.size(); ++i)
+	{
+		connections[i].disconnect();
+	}
+	REQUIRE(event.capacity() < 100);
+	event(1);
+	REQUIRE(sum == 10);
+
+	event.set_shrink_policy(shrink_policy::manual);
+	for (int i = 0; i < 1000; ++i)
+	{
+		connections.push_back(event.connect([](int) {
+		}));
+	}
+	const size_t capacity = event.capacity();
+	event.disconnect_all_slots();
+	REQUIRE(event.capacity() == capacity);
+}
+
+TEST_CASE("Parallel emission calls all slots and combines results in connection order", "[signal]")
+{
+	signal<int(int), vector_combiner> event;
+	std::mutex callsMutex;
+	std::vector<int> calledSlots;
+	for (int i = 0; i < 100; ++i)
+	{
+		event.connect([i, &callsMutex, &calledSlots](int value) {
+			std::lock_guard lock(callsMutex);
+			calledSlots.push_back(i);
+			return value * i;
+		});
+	}
+	event.set_parallel_emission(std::make_shared<thread_pool>(4), 8);
+
+	const std::vector<int> results = event(2);
+	REQUIRE(results.size() == 100);
+	for (int i = 0; i < 100; ++i)
+	{
+		REQUIRE(results[i] == 2 * i);
+	}
+	std::sort(calledSlots.begin(), calledSlots.end());
+	for (int i = 0; i < 100; ++i)
+	{
+		REQUIRE(calledSlots[i] == i);
+	}
+
+	signal<int()> lastValueEvent;
+	for (int i = 0; i < 100; ++i)
+	{
+		lastValueEvent.connect([i] {
+			return i;
+		});
+	}
+	lastValueEvent.set_parallel_emission(std::make_shared<thread_pool>(4));
+	REQUIRE(lastValueEvent() == 99);
+	lastValueEvent.freeze();
+	REQUIRE(lastValueEvent() == 99);
+	lastValueEvent.set_parallel_emission(nullptr);
+	REQUIRE(lastValueEvent() == 99);
+}
+
+TEST_CASE("Parallel emission rethrows exception thrown by slot", "[signal]")
+{
+	auto pool = std::make_shared<thread_pool>(2);
+	signal<void()> event;
+	std::atomic<int> callCount = 0;
+	for (int i = 0; i < 10; ++i)
+	{
+		event.connect([i, &callCount] {
+			++callCount;
+			if (i == 5)
+			{
+				throw std::runtime_error("slot failed");
+			}
+		});
+	}
+	event.set_parallel_emission(pool);
+
+	REQUIRE_THROWS_AS(event(), std::runtime_error);
+	REQUIRE(callCount == 10);
+}
+
+TEST_CASE("Queued connection calls slot on executor thread", "[signal]")
+{
+	thread_executor executor;
+	signal<void(const std::string&, int)> event;
+	std::vector<std::string> values;
+	std::thread::id slotThreadId;
+	event.connect([&](const std::string& text, int value) {
+		values.push_back(text + std::to_string(value));
+		slotThreadId = std::this_thread::get_id();
+	}, executor);
+
+	std::string text = "value";
+	event(text, 1);
+	text = "changed";
+	event(text, 2);
+
+	std::promise<void> done;
+	executor.post([&done] {
+		done.set_value();
+	});
+	done.get_future().wait();
+	REQUIRE(slotThreadId != std::this_thread::get_id());
+	REQUIRE(values == std::vector<std::string>{ "value1", "changed2" });
+}
+
+TEST_CASE("Queued connection does not call slot after disconnect", "[signal]")
+{
+	thread_executor executor;
+	signal<void(int)> event;
+	std::atomic<int> callCount = 0;
+	std::promise<void> blocked;
+	std::promise<void> unblocked;
+	auto unblockedFuture = unblocked.get_future();
+
+	// Keeps executor busy while signal emitted and slot disconnected.
+	executor.post([&] {
+		blocked.set_value();
+		unblockedFuture.wait();
+	});
+	blocked.get_future().wait();
+
+	auto conn = event.connect([&callCount](int) {
+		++callCount;
+	}, executor);
+	event(1);
+	conn.disconnect();
+	unblocked.set_value();
+
+	std::promise<void> done;
+	executor.post([&done] {
+		done.set_value();
+	});
+	done.get_future().wait();
+	REQUIRE(callCount == 0);
+}
+
+namespace
+{
+// Executor which runs tasks only when test asks it.
+class manual_executor : public executor
+{
+public:
+	manual_executor() = default;
+	explicit manual_executor(std::size_t queueCapacity)
+		: executor(queueCapacity)
+	{
+	}
+
+	using executor::run_queued_tasks;
+
+protected:
+	void wakeup() noexcept override
+	{
+	}
+};
+} // namespace
+
+TEST_CASE("Queued connection with limited queue drops newest or oldest emissions", "[signal]")
+{
+	manual_executor executor;
+	signal<void(int)> event;
+	std::vector<int> newestDroppedValues;
+	std::vector<int> oldestDroppedValues;
+	auto newestDropped = event.connect([&](int value) {
+		newestDroppedValues.push_back(value);
+	}, executor, { 2, overflow_policy::drop_newest });
+	auto oldestDropped = event.connect([&](int value) {
+		oldestDroppedValues.push_back(value);
+	}, executor, { 2, overflow_policy::drop_oldest });
+
+	for (int i = 1; i <= 5; ++i)
+	{
+		event(i);
+	}
+	REQUIRE(executor.run_queued_tasks() == 4);
+	REQUIRE(newestDroppedValues == std::vector<int>{ 1, 2 });
+	REQUIRE(oldestDroppedValues == std::vector<int>{ 4, 5 });
+	REQUIRE(newestDropped.dropped_count() == 3);
+	REQUIRE(oldestDropped.dropped_count() == 3);
+	REQUIRE(oldestDropped.coalesced_count() == 0);
+
+	event(6);
+	REQUIRE(executor.run_queued_tasks() == 2);
+	REQUIRE(newestDroppedValues == std::vector<int>{ 1, 2, 6 });
+	REQUIRE(oldestDroppedValues == std::vector<int>{ 4, 5, 6 });
+}
+
+TEST_CASE("Queued connection with coalesce policy delivers only the latest emission", "[signal]")
+{
+	manual_executor executor;
+	signal<void(const std::string&)> event;
+	std::vector<std::string> values;
+	auto conn = event.connect([&values](const std::string& value) {
+		values.push_back(value);
+	}, executor, { 100, overflow_policy::coalesce });
+
+	event("first");
+	event("second");
+	event("third");
+	REQUIRE(executor.run_queued_tasks() == 1);
+	REQUIRE(values == std::vector<std::string>{ "third" });
+	REQUIRE(conn.coalesced_count() == 2);
+	REQUIRE(conn.dropped_count() == 0);
+
+	conn.disconnect();
+	event("fourth");
+	REQUIRE(executor.run_queued_tasks() == 0);
+	REQUIRE(values.size() == 1);
+}
+
+TEST_CASE("Queued connection delivers emissions after executor rejected task", "[signal]")
+{
+	manual_executor executor(1);
+	signal<void(int)> event;
+	std::vector<int> values;
+	auto conn = event.connect([&values](int value) {
+		values.push_back(value);
+	}, executor, { 1, overflow_policy::coalesce });
+
+	executor.post([] {});
+	REQUIRE_THROWS_AS(event(1), std::length_error);
+	REQUIRE(executor.run_queued_tasks() == 1);
+
+	event(2);
+	REQUIRE(executor.run_queued_tasks() == 1);
+	REQUIRE(values == std::vector<int>{ 2 });
+	REQUIRE(conn.coalesced_count() == 0);
+}
+
+TEST_CASE("Queued connection with block policy waits for executor", "[signal]")
+{
+	thread_executor executor;
+	signal<void(int)> event;
+	std::atomic<int> sum = 0;
+	std::atomic<int> maxPending = 0;
+	std::atomic<int> pending = 0;
+	auto conn = event.connect([&](int value) {
+		std::this_thread::sleep_for(std::chrono::microseconds(100));
+		sum += value;
+		--pending;
+	}, executor, { 4, overflow_policy::block });
+
+	for (int i = 1; i <= 100; ++i)
+	{
+		maxPending = std::max(maxPending.load(), ++pending);
+		event(i);
+	}
+	std::promise<void> done;
+	executor.post([&done] {
+		done.set_value();
+	});
+	done.get_future().wait();
+
+	REQUIRE(sum == 5050);
+	REQUIRE(conn.dropped_count() == 0);
+	// Besides 4 queued emissions, one is delivered right now and one is counted before emitting thread blocks.
+	REQUIRE(maxPending <= 6);
+}
+
+TEST_CASE("Wait for emission returns false on timeout", "[signal]")
+{
+	signal<void(int)> event;
+	REQUIRE(!event.wait(std::chrono::milliseconds(10)));
+	REQUIRE(!event.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1)));
+	REQUIRE(!event.wait_until(std::chrono::system_clock::now() - std::chrono::seconds(1)));
+}
+
+TEST_CASE("Emission wakes all threads which wait for it", "[signal]")
+{
+	constexpr int waiterCount = 4;
+	signal<void(int)> event;
+	std::atomic<int> value = 0;
+	event.connect([&value](int newValue) {
+		value = newValue;
+	});
+
+	std::atomic<int> startedCount = 0;
+	std::atomic<int> wokenCount = 0;
+	std::vector<std::thread> waiters;
+	for (int i = 0; i < waiterCount; ++i)
+	{
+		waiters.emplace_back([&] {
+			++startedCount;
+			// Slots are called before waiters are woken up.
+			if (event.wait(std::chrono::seconds(10)) && value != 0)
+			{
+				++wokenCount;
+			}
+		});
+	}
+
+	while (startedCount != waiterCount)
+	{
+		std::this_thread::yield();
+	}
+	// Waiter thread can be preempted between counter increment and wait, so emit until all of them woken up.
+	for (int i = 1; wokenCount != waiterCount && i < 10000; ++i)
+	{
+		event(i);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	for (auto& waiter : waiters)
+	{
+		waiter.join();
+	}
+	REQUIRE(wokenCount == waiterCount);
+}
+
+TEST_CASE("Asynchronous emission without thread pool calls slots before returning", "[signal]")
+{
+	signal<int(int)> event;
+	event.connect([](int value) {
+		return value + 1;
+	});
+	event.connect([](int value) {
+		return value * 2;
+	});
+
+	auto future = event.emit_async(10);
+	REQUIRE(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+	REQUIRE(future.get() == 20);
+
+	signal<void()> emptyEvent;
+	REQUIRE(emptyEvent.emit_async().wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+TEST_CASE("Asynchronous emission on thread pool combines results in connection order", "[signal]")
+{
+	signal<std::string(const std::string&), vector_combiner> event;
+	for (int i = 0; i < 50; ++i)
+	{
+		event.connect([i](const std::string& value) {
+			return value + std::to_string(i);
+		});
+	}
+	event.set_parallel_emission(std::make_shared<thread_pool>(2), 3);
+
+	std::future<std::vector<std::string>> future;
+	{
+		// Arguments are copied, so they can be destroyed before slots called.
+		std::string value = "slot";
+		future = event.emit_async(value);
+	}
+	const std::vector<std::string> results = future.get();
+	REQUIRE(results.size() == 50);
+	for (int i = 0; i < 50; ++i)
+	{
+		REQUIRE(results[i] == "slot" + std::to_string(i));
+	}
+}
+
+TEST_CASE("Asynchronous emission keeps exception thrown by slot", "[signal]")
+{
+	signal<void(int)> event;
+	std::atomic<int> callCount = 0;
+	event.connect([&callCount](int) {
+		++callCount;
+		throw std::runtime_error("slot failed");
+	});
+	event.connect([&callCount](int) {
+		++callCount;
+	});
+	event.set_parallel_emission(std::make_shared<thread_pool>(2));
+
+	auto future = event.emit_async(1);
+	REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+	REQUIRE(callCount == 2);
+}
+
+TEST_CASE("Signal can be destroyed inside its slot during asynchronous emission", "[signal]")
+{
+	std::optional<signal<void()>> s;
+	s.emplace();
+	s->connect([&] {
+		s.reset();
+	});
+	bool called = false;
+	s->connect([&] {
+		called = true;
+	});
+	auto future = s->emit_async();
+	REQUIRE(future.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+	CHECK(called);
+}
+
+TEST_CASE("Asynchronous emission on thread pool wakes waiters after slots called", "[signal]")
+{
+	signal<void()> event;
+	std::atomic<int> callCount = 0;
+	event.connect([&callCount] {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		++callCount;
+	});
+	event.set_parallel_emission(std::make_shared<thread_pool>(1));
+
+	std::atomic<bool> started = false;
+	std::atomic<bool> woken = false;
+	std::atomic<int> callCountWhenWoken = -1;
+	std::thread waiter([&] {
+		started = true;
+		if (event.wait(std::chrono::seconds(10)))
+		{
+			callCountWhenWoken = callCount.load();
+			woken = true;
+		}
+	});
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+	// Waiter thread can be preempted before it waits, so emit until it's woken up.
+	for (int i = 0; !woken && i < 100; ++i)
+	{
+		event.emit_async().get();
+	}
+	waiter.join();
+	REQUIRE(woken);
+	REQUIRE(callCountWhenWoken >= 1);
+}
+
+TEST_CASE("Batch emission calls each slot for all items before calling the next slot", "[signal]")
+{
+	signal<void(int, const std::string&)> event;
+	std::vector<std::string> calls;
+	event.connect([&calls](int value, const std::string& text) {
+		calls.push_back("first " + std::to_string(value) + text);
+	});
+	event.connect([&calls](int value, const std::string& text) {
+		calls.push_back("second " + std::to_string(value) + text);
+	});
+
+	const std::vector<std::tuple<int, std::string>> items = { { 1, "a" }, { 2, "b" }, { 3, "c" } };
+	event.emit_batch(items);
+	REQUIRE(calls == std::vector<std::string>{ "first 1a", "first 2b", "first 3c", "second 1a", "second 2b", "second 3c" });
+
+	calls.clear();
+	event.freeze();
+	event.emit_batch(items);
+	REQUIRE(calls.size() == 6);
+	REQUIRE(calls[3] == "second 1a");
+}
+
+TEST_CASE("Batch slot receives all items of batch emission with single call", "[signal]")
+{
+	signal<void(int)> event;
+	std::vector<std::vector<int>> batches;
+	event.connect_batch([&batches](span<const std::tuple<int>> items) {
+		std::vector<int> values;
+		for (const auto& [value] : items)
+		{
+			values.push_back(value);
+		}
+		batches.push_back(values);
+	});
+	int sum = 0;
+	event.connect([&sum](int value) {
+		sum += value;
+	});
+
+	event(5);
+	REQUIRE(batches == std::vector<std::vector<int>>{ { 5 } });
+
+	const std::array<std::tuple<int>, 3> items = { std::tuple<int>(1), std::tuple<int>(2), std::tuple<int>(3) };
+	event.emit_batch(items);
+	REQUIRE(batches == std::vector<std::vector<int>>{ { 5 }, { 1, 2, 3 } });
+	REQUIRE(sum == 11);
+}
+
+TEST_CASE("Blocked signal doesn't call slots until unblocked", "[signal]")
+{
+	signal<int(int)> event;
+	int callCount = 0;
+	event.connect([&callCount](int value) {
+		++callCount;
+		return value;
+	});
+
+	event.block();
+	event.block();
+	REQUIRE(event.is_blocked());
+	REQUIRE(event(1) == std::nullopt);
+	REQUIRE(event.emit_async(2).get() == std::nullopt);
+
+	event.unblock();
+	REQUIRE(event.is_blocked());
+	REQUIRE(event(3) == std::nullopt);
+	REQUIRE(callCount == 0);
+
+	event.unblock();
+	REQUIRE(!event.is_blocked());
+	REQUIRE(event(4) == 4);
+	REQUIRE(callCount == 1);
+}
+
+TEST_CASE("Signal blocker blocks signal while it exists", "[signal]")
+{
+	signal<void(int)> event;
+	std::vector<int> values;
+	event.connect([&values](int value) {
+		values.push_back(value);
+	});
+
+	{
+		signal_blocker blocker(event);
+		REQUIRE(blocker.blocking());
+		event(1);
+		event.emit_batch(std::vector<std::tuple<int>>{ { 2 } });
+
+		signal_blocker movedBlocker = std::move(blocker);
+		REQUIRE(!blocker.blocking());
+		REQUIRE(movedBlocker.blocking());
+		event(3);
+
+		movedBlocker.unblock();
+		event(4);
+		movedBlocker.block();
+		event(5);
+	}
+	event(6);
+	REQUIRE(values == std::vector<int>{ 4, 6 });
+}
+
+TEST_CASE("Signal blocker can outlive signal", "[signal]")
+{
+	signal_blocker blocker;
+	{
+		signal<void()> event;
+		blocker = signal_blocker(event);
+		REQUIRE(event.is_blocked());
+	}
+	blocker.unblock();
+	REQUIRE(!blocker.blocking());
+}
+
+TEST_CASE("Slot connected with connect_once is called once", "[signal]")
+{
+	signal<void(int)> event;
+	std::vector<int> calls;
+	auto conn = event.connect_once([&calls](int value) {
+		calls.push_back(value);
+	});
+	event.connect([&calls](int value) {
+		calls.push_back(-value);
+	});
+	REQUIRE(conn.connected());
+
+	event(1);
+	REQUIRE(!conn.connected());
+	REQUIRE(event.num_slots() == 1);
+	event(2);
+	REQUIRE(calls == std::vector<int>{ 1, -1, -2 });
+	conn.disconnect();
+}
+
+TEST_CASE("Slot connected with connect_n is called given number of times", "[signal]")
+{
+	signal<int()> event;
+	int callCount = 0;
+	auto conn = event.connect_n([&callCount] {
+		return ++callCount;
+	}, 3);
+	REQUIRE(!event.connect_n([] {
+		return 0;
+	}, 0).connected());
+
+	REQUIRE(event() == 1);
+	REQUIRE(event() == 2);
+	REQUIRE(conn.connected());
+	REQUIRE(event() == 3);
+	REQUIRE(!conn.connected());
+	REQUIRE(!event().has_value());
+	REQUIRE(callCount == 3);
+}
+
+TEST_CASE("Slot connected with connect_n can be disconnected before the last call", "[signal]")
+{
+	signal<void()> event;
+	int callCount = 0;
+	auto slot = [&callCount] {
+		++callCount;
+	};
+	auto first = event.connect_n(slot, 2);
+	auto second = event.connect_n(slot, 2);
+	event();
+	first.disconnect();
+	event();
+	event();
+	REQUIRE(callCount == 3);
+	REQUIRE(!second.connected());
+	REQUIRE(event.empty());
+
+	event.connect_once(slot);
+	REQUIRE_THROWS_AS(event.freeze(), std::logic_error);
+	event.disconnect_all_slots();
+	event.freeze();
+	REQUIRE(event.is_frozen());
+}
+
+TEST_CASE("Slot retired by emission is destroyed after signal unlocked", "[signal]")
+{
+	signal<void()> event;
+	auto guard = std::shared_ptr<int>(new int(0), [&event](int* value) {
+		delete value;
+		event.connect([] {
+		});
+	});
+	event.connect_once([guard] {
+	});
+	guard.reset();
+
+	event();
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Slot connected with connect_once is called once by concurrent emissions", "[signal]")
+{
+	for (int i = 0; i < 100; ++i)
+	{
+		signal<void()> event;
+		std::atomic<int> callCount = 0;
+		event.connect_once([&callCount] {
+			++callCount;
+		});
+		std::thread other([&event] {
+			event();
+		});
+		event();
+		other.join();
+		REQUIRE(callCount == 1);
+	}
+}
+
+TEST_CASE("Slot connected with connect_n counts parallel emissions", "[signal]")
+{
+	signal<int()> event;
+	event.set_parallel_emission(std::make_shared<thread_pool>(2), 1);
+	std::atomic<int> callCount = 0;
+	auto conn = event.connect_n([&callCount] {
+		return ++callCount;
+	}, 2);
+	event.connect([] {
+		return 0;
+	});
+
+	event();
+	REQUIRE(conn.connected());
+	event();
+	REQUIRE(!conn.connected());
+	event();
+	REQUIRE(callCount == 2);
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Calls slots in order of groups and positions", "[signal]")
+{
+	signal<void()> event;
+	std::string order;
+	const auto append = [&order](char c) {
+		return [&order, c] {
+			order += c;
+		};
+	};
+	event.connect(append('e'));
+	event.connect(2, append('d'));
+	event.connect(1, append('c'));
+	event.connect(append('a'), connect_position::at_front);
+	event.connect(append('f'), connect_position::at_back);
+	event.connect(1, append('b'), connect_position::at_front);
+	event.connect(-5, append('0'));
+	event.connect(append('_'), connect_position::at_front);
+
+	event();
+	REQUIRE(order == "_a0bcdef");
+	REQUIRE(event.num_slots() == 8);
+}
+
+TEST_CASE("Disconnects slots connected to groups", "[signal]")
+{
+	signal<void()> event;
+	std::string order;
+	const auto append = [&order](char c) {
+		return [&order, c] {
+			order += c;
+		};
+	};
+	auto a = event.connect(append('a'), connect_position::at_front);
+	auto b = event.connect(1, append('b'));
+	auto c = event.connect(1, append('c'));
+	event.connect(append('d'));
+
+	b.disconnect();
+	REQUIRE(!b.connected());
+	REQUIRE(c.connected());
+	event();
+	REQUIRE(order == "acd");
+
+	order.clear();
+	a.disconnect();
+	c.disconnect();
+	event();
+	REQUIRE(order == "d");
+	REQUIRE(event.num_slots() == 1);
+
+	connection_group group;
+	group.add(event.connect(3, append('e')));
+	group.add(event.connect(append('f'), connect_position::at_front));
+	group.disconnect();
+	order.clear();
+	event();
+	REQUIRE(order == "d");
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Calls grouped slots connected during emission only after current slot", "[signal]")
+{
+	signal<void()> event;
+	std::string order;
+	event.connect(1, [&] {
+		order += 'b';
+		event.connect(0, [&order] {
+			order += 'x';
+		});
+		event.connect(2, [&order] {
+			order += 'y';
+		});
+		event.connect([&order] {
+			order += 'z';
+		}, connect_position::at_front);
+	});
+	event.connect([&order] {
+		order += 'c';
+	});
+
+	event();
+	REQUIRE(order == "byc");
+	order.clear();
+	event.disconnect_all_slots();
+	event();
+	REQUIRE(order.empty());
+}
+
+TEST_CASE("Keeps order of groups in frozen and parallel emission", "[signal]")
+{
+	signal<void()> event;
+	std::string order;
+	event.connect([&order] {
+		order += 'c';
+	});
+	event.connect(1, [&order] {
+		order += 'b';
+	});
+	event.connect([&order] {
+		order += 'a';
+	}, connect_position::at_front);
+
+	event.freeze();
+	event();
+	REQUIRE(order == "abc");
+
+	event.unfreeze();
+	event.set_parallel_emission(std::make_shared<thread_pool>(1), 3);
+	order.clear();
+	event();
+	REQUIRE(order == "abc");
+}
+
+namespace
+{
+int g_disconnectedSlotCalls = 0;
+
+void count_call(int value)
+{
+	g_disconnectedSlotCalls += value;
+}
+
+void count_double_call(int value)
+{
+	g_disconnectedSlotCalls += 2 * value;
+}
+
+class call_counter
+{
+public:
+	void on_value(int value)
+	{
+		m_sum += value;
+	}
+
+	int sum() const
+	{
+		return m_sum;
+	}
+
+private:
+	int m_sum = 0;
+};
+
+struct comparable_slot
+{
+	void operator()(int value) const
+	{
+		*sum += value;
+	}
+
+	bool operator==(const comparable_slot& other) const
+	{
+		return sum == other.sum;
+	}
+
+	int* sum = nullptr;
+};
+} // namespace
+
+TEST_CASE("Disconnects function pointer slot", "[signal]")
+{
+	signal<void(int)> event;
+	g_disconnectedSlotCalls = 0;
+	auto conn = event.connect(count_call);
+	event.connect(&count_double_call);
+	event.connect(count_call);
+	event(1);
+	REQUIRE(g_disconnectedSlotCalls == 4);
+
+	// All equal slots are disconnected, as boost::signals2 does.
+	event.disconnect(&count_call);
+	REQUIRE(!conn.connected());
+	REQUIRE(event.num_slots() == 1);
+	g_disconnectedSlotCalls = 0;
+	event(1);
+	REQUIRE(g_disconnectedSlotCalls == 2);
+
+	// Disconnecting slot which isn't connected does nothing.
+	event.disconnect(count_call);
+	REQUIRE(event.num_slots() == 1);
+	event.disconnect(count_double_call);
+	REQUIRE(event.empty());
+}
+
+TEST_CASE("Disconnects method slot by object", "[signal]")
+{
+	signal<void(int)> event;
+	call_counter first;
+	call_counter second;
+	event.connect(mem_fn_slot<&call_counter::on_value>(&first));
+	event.connect(delegate<void(int)>(mem_fn_slot<&call_counter::on_value>(&second)));
+	event(1);
+
+	event.disconnect(mem_fn_slot<&call_counter::on_value>(&first));
+	REQUIRE(event.num_slots() == 1);
+	event(1);
+	REQUIRE(first.sum() == 1);
+	REQUIRE(second.sum() == 2);
+
+	event.disconnect(delegate<void(int)>(mem_fn_slot<&call_counter::on_value>(&second)));
+	REQUIRE(event.empty());
+}
+
+TEST_CASE("Disconnects slot compared with operator==", "[signal]")
+{
+	signal<void(int)> event;
+	int first = 0;
+	int second = 0;
+	event.connect(comparable_slot{ &first });
+	event.connect(comparable_slot{ &second });
+	event.connect([&first](int value) {
+		first += 10 * value;
+	});
+
+	event.disconnect(comparable_slot{ &first });
+	REQUIRE(event.num_slots() == 2);
+	event(1);
+	REQUIRE(first == 10);
+	REQUIRE(second == 1);
+}
+
+TEST_CASE("Slot operator== can use signal which disconnects it", "[signal]")
+{
+	struct counting_slot
+	{
+		void operator()() const
+		{
+		}
+
+		bool operator==(const counting_slot& other) const
+		{
+			// Signal is unlocked while slots are compared.
+			*slotCount = event->num_slots();
+			return id == other.id;
+		}
+
+		signal<void()>* event = nullptr;
+		size_t* slotCount = nullptr;
+		int id = 0;
+	};
+
+	signal<void()> event;
+	size_t slotCount = 0;
+	event.connect(counting_slot{ &event, &slotCount, 1 });
+	event.connect(counting_slot{ &event, &slotCount, 2 });
+
+	event.disconnect(counting_slot{ &event, &slotCount, 1 });
+	REQUIRE(slotCount == 2);
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Disconnects equal slots in groups, with handles and limits", "[signal]")
+{
+	signal<void(int)> event;
+	g_disconnectedSlotCalls = 0;
+	event.connect(1, count_call);
+	event.connect(count_call, connect_position::at_front);
+	auto handle = event.connect(count_call, handle_tag{});
+	auto limited = event.connect_n(count_call, 5);
+	event.connect(count_double_call);
+	REQUIRE(event.num_slots() == 5);
+
+	event.disconnect(count_call);
+	REQUIRE(event.num_slots() == 1);
+	REQUIRE(!handle.connected());
+	REQUIRE(!limited.connected());
+	event(1);
+	REQUIRE(g_disconnectedSlotCalls == 2);
+
+	// Slots removed by other ways leave no index entries.
+	auto conn = event.connect(count_call);
+	conn.disconnect();
+	event.connect_once(count_call);
+	event(1);
+	event.disconnect_all_slots();
+	event.connect(count_call);
+	event.disconnect(count_call);
+	REQUIRE(event.empty());
+}
@@ -0,0 +1,71 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/thread_pool.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace is::signals;
+
+TEST_CASE("Runs posted tasks before destruction", "[thread_pool]")
+{
+	std::atomic<int> callCount = 0;
+	{
+		thread_pool pool(3);
+		REQUIRE(pool.size() == 3);
+		for (int i = 0; i < 100; ++i)
+		{
+			pool.post([&callCount] {
+				++callCount;
+			});
+		}
+	}
+	REQUIRE(callCount == 100);
+}
+
+TEST_CASE("Parallel for processes each item once", "[thread_pool]")
+{
+	thread_pool pool(4);
+	for (size_t grainSize : { 0, 1, 3, 7, 100, 1000 })
+	{
+		std::vector<std::atomic<int>> counters(100);
+		pool.parallel_for(counters.size(), grainSize, [&counters](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+			{
+				++counters[i];
+			}
+		});
+		for (const auto& counter : counters)
+		{
+			REQUIRE(counter == 1);
+		}
+	}
+}
+
+TEST_CASE("Parallel for can be nested", "[thread_pool]")
+{
+	thread_pool pool(2);
+	std::atomic<int> sum = 0;
+	pool.parallel_for(10, 1, [&](size_t, size_t) {
+		pool.parallel_for(10, 1, [&](size_t begin, size_t end) {
+			sum += int(end - begin);
+		});
+	});
+	REQUIRE(sum == 100);
+}
+
+TEST_CASE("Parallel for rethrows exception after all chunks finished", "[thread_pool]")
+{
+	thread_pool pool(2);
+	std::atomic<int> chunkCount = 0;
+	auto parallelFor = [&] {
+		pool.parallel_for(10, 1, [&chunkCount](size_t begin, size_t) {
+			++chunkCount;
+			if (begin == 3)
+			{
+				throw std::runtime_error("chunk failed");
+			}
+		});
+	};
+	REQUIRE_THROWS_AS(parallelFor(), std::runtime_error);
+	REQUIRE(chunkCount == 10);
+}
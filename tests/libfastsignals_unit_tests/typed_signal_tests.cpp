@@ -0,0 +1,178 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/signal.h"
+#include "libfastsignals/include/typed_signal.h"
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+class Counter
+{
+public:
+	void add(int value)
+	{
+		m_total += value;
+	}
+
+	int total() const
+	{
+		return m_total;
+	}
+
+private:
+	int m_total = 0;
+};
+
+// Keeps object pointer instead of capturing it, so the slot is assignable.
+struct CounterSlot
+{
+	Counter* counter = nullptr;
+
+	void operator()(int value) const
+	{
+		counter->add(value);
+	}
+};
+
+int g_lastValue = 0;
+
+int remember(int value)
+{
+	g_lastValue = value;
+	return value * 2;
+}
+
+int negate(int value)
+{
+	return -value;
+}
+} // namespace
+
+TEST_CASE("Typed signal calls slots in connection order", "[typed_signal]")
+{
+	typed_signal<void(int), CounterSlot> event;
+	std::vector<Counter> counters(3);
+	for (auto& counter : counters)
+	{
+		event.connect(CounterSlot{ &counter });
+	}
+	REQUIRE(event.num_slots() == 3);
+
+	event(5);
+	event(2);
+	for (const auto& counter : counters)
+	{
+		REQUIRE(counter.total() == 7);
+	}
+}
+
+TEST_CASE("Typed signal stores function pointers and returns value with combiner", "[typed_signal]")
+{
+	typed_signal<int(int), int (*)(int)> event;
+	REQUIRE(!event(1));
+
+	event.connect(remember);
+	auto conn = event.connect(negate);
+	REQUIRE(event(3) == -3);
+	REQUIRE(g_lastValue == 3);
+
+	conn.disconnect();
+	REQUIRE(event(4) == 8);
+	REQUIRE(event.num_slots() == 1);
+}
+
+TEST_CASE("Typed signal returns compatible connections", "[typed_signal]")
+{
+	typed_signal<void(int), CounterSlot> event;
+	Counter first;
+	Counter second;
+	Counter third;
+	{
+		scoped_connection scoped = event.connect(CounterSlot{ &first });
+		connection_group group;
+		group.add(event.connect(CounterSlot{ &second }));
+		auto conn = event.connect(CounterSlot{ &third });
+		REQUIRE(conn.connected());
+		event(1);
+		REQUIRE(first.total() == 1);
+		REQUIRE(second.total() == 1);
+		REQUIRE(third.total() == 1);
+	}
+	REQUIRE(event.num_slots() == 1);
+	event(1);
+	REQUIRE(first.total() == 1);
+	REQUIRE(second.total() == 1);
+	REQUIRE(third.total() == 2);
+
+	event.disconnect_all_slots();
+	REQUIRE(event.empty());
+}
+
+TEST_CASE("Typed signal skips slots disconnected during emission", "[typed_signal]")
+{
+	struct DisconnectingSlot
+	{
+		std::vector<connection>* connections = nullptr;
+		int* calls = nullptr;
+
+		void operator()() const
+		{
+			++*calls;
+			for (auto& conn : *connections)
+			{
+				conn.disconnect();
+			}
+		}
+	};
+
+	typed_signal<void(), DisconnectingSlot> event;
+	std::vector<connection> connections;
+	int calls = 0;
+	for (int i = 0; i < 40; ++i)
+	{
+		connections.push_back(event.connect(DisconnectingSlot{ &connections, &calls }));
+	}
+
+	event();
+	REQUIRE(calls == 1);
+	REQUIRE(event.empty());
+}
+
+TEST_CASE("Typed signal doesn't call slots connected during emission", "[typed_signal]")
+{
+	struct ConnectingSlot
+	{
+		typed_signal<void(), ConnectingSlot>* event = nullptr;
+		int* calls = nullptr;
+
+		void operator()() const
+		{
+			++*calls;
+			event->connect(*this);
+		}
+	};
+
+	typed_signal<void(), ConnectingSlot> event;
+	int calls = 0;
+	event.connect(ConnectingSlot{ &event, &calls });
+
+	event();
+	REQUIRE(calls == 1);
+	REQUIRE(event.num_slots() == 2);
+	event();
+	REQUIRE(calls == 3);
+	REQUIRE(event.num_slots() == 4);
+}
+
+TEST_CASE("Typed signal connection outlives signal", "[typed_signal]")
+{
+	Counter counter;
+	connection conn;
+	{
+		typed_signal<void(int), CounterSlot> event;
+		conn = event.connect(CounterSlot{ &counter });
+	}
+	REQUIRE(!conn.connected());
+	conn.disconnect();
+}
@@ -0,0 +1,168 @@
+#include "catch2/catch.hpp"
+#include "libfastsignals/include/unordered_signal.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace is::signals;
+
+namespace
+{
+int g_freeFunctionCalls = 0;
+
+void free_function(int value)
+{
+	g_freeFunctionCalls += value;
+}
+} // namespace
+
+TEST_CASE("Unordered signal calls each slot once", "[unordered_signal]")
+{
+	unordered_signal<void(int)> event;
+	std::vector<int> values;
+	for (int i = 0; i < 10; ++i)
+	{
+		event.connect([&values, i](int value) {
+			values.push_back(i * value);
+		});
+	}
+	g_freeFunctionCalls = 0;
+	event.connect(free_function);
+	REQUIRE(event.num_slots() == 11);
+
+	event(2);
+	std::sort(values.begin(), values.end());
+	REQUIRE(values == std::vector<int>{ 0, 2, 4, 6, 8, 10, 12, 14, 16, 18 });
+	REQUIRE(g_freeFunctionCalls == 2);
+}
+
+TEST_CASE("Unordered signal disconnects slots", "[unordered_signal]")
+{
+	unordered_signal<void()> event;
+	std::vector<int> calls;
+	std::vector<connection> connections;
+	for (int i = 0; i < 5; ++i)
+	{
+		connections.push_back(event.connect([&calls, i] {
+			calls.push_back(i);
+		}));
+	}
+
+	connections[1].disconnect();
+	connections[3].disconnect();
+	REQUIRE(!connections[1].connected());
+	REQUIRE(connections[4].connected());
+	REQUIRE(event.num_slots() == 3);
+	event();
+	std::sort(calls.begin(), calls.end());
+	REQUIRE(calls == std::vector<int>{ 0, 2, 4 });
+
+	// Slot moved on disconnect is still found by its connection.
+	connections[4].disconnect();
+	calls.clear();
+	event();
+	std::sort(calls.begin(), calls.end());
+	REQUIRE(calls == std::vector<int>{ 0, 2 });
+
+	event.disconnect_all_slots();
+	REQUIRE(event.empty());
+	REQUIRE(!connections[0].connected());
+	calls.clear();
+	event();
+	REQUIRE(calls.empty());
+}
+
+TEST_CASE("Unordered signal skips slots disconnected during emission", "[unordered_signal]")
+{
+	unordered_signal<void()> event;
+	std::vector<int> calls;
+	std::vector<connection> connections(6);
+	for (int i = 0; i < 6; ++i)
+	{
+		connections[i] = event.connect([&, i] {
+			calls.push_back(i);
+			// The first called slot disconnects all others.
+			for (auto& conn : connections)
+			{
+				conn.disconnect();
+			}
+		});
+	}
+
+	event();
+	REQUIRE(calls.size() == 1);
+	REQUIRE(event.empty());
+
+	// Slots connected during emission are compacted normally.
+	calls.clear();
+	auto conn = event.connect([&calls] {
+		calls.push_back(10);
+	});
+	event();
+	REQUIRE(calls == std::vector<int>{ 10 });
+	conn.disconnect();
+	REQUIRE(event.empty());
+}
+
+TEST_CASE("Unordered signal returns value with combiner", "[unordered_signal]")
+{
+	unordered_signal<int(int), optional_last_value> event;
+	REQUIRE(!event(1));
+	auto conn = event.connect([](int value) {
+		return value * 3;
+	});
+	REQUIRE(event(2) == 6);
+	conn.disconnect();
+	REQUIRE(!event(2));
+}
+
+TEST_CASE("Unordered signal connection outlives signal", "[unordered_signal]")
+{
+	connection conn;
+	{
+		unordered_signal<void()> event;
+		conn = event.connect([] {
+		});
+		REQUIRE(conn.connected());
+	}
+	REQUIRE(!conn.connected());
+	conn.disconnect();
+}
+
+TEST_CASE("Unordered signal can be emitted and disconnected concurrently", "[unordered_signal]")
+{
+	unordered_signal<void()> event;
+	std::atomic<int> calls = 0;
+	std::vector<connection> connections;
+	for (int i = 0; i < 100; ++i)
+	{
+		connections.push_back(event.connect([&calls] {
+			++calls;
+		}));
+	}
+	// Slot which stays connected is called by each emission exactly once.
+	std::atomic<int> keptCalls = 0;
+	event.connect([&keptCalls] {
+		++keptCalls;
+	});
+
+	std::thread emitter([&event] {
+		for (int i = 0; i < 100; ++i)
+		{
+			event();
+		}
+	});
+	for (auto& conn : connections)
+	{
+		conn.disconnect();
+	}
+	emitter.join();
+
+	REQUIRE(keptCalls == 100);
+	REQUIRE(event.num_slots() == 1);
+	calls = 0;
+	event();
+	REQUIRE(calls == 0);
+	REQUIRE(keptCalls == 101);
+}